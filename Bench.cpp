@@ -0,0 +1,1167 @@
+/**
+ * @file Bench.cpp
+ * @brief Benchmark and report driver for the cowboy vs ninja engine.
+ * Run all sections with ./bench or a subset with ./bench <section>...
+ * ./bench --save runs the regression section and stores its results under the current git revision in
+ * bench_baseline.txt (--baseline <file> for another file), ./bench --compare compares a new run with the most
+ * recent stored results and exits with 2 if one of them is significantly slower.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/ioctl.h>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "sources/Team.hpp"
+#include "sources/ResultsAggregator.hpp"
+#include "sources/BattleCoroutine.hpp"
+
+using namespace std;
+using namespace ariel;
+
+// Every allocation of the bench goes through these, so a section can count the allocations of the code it times.
+static atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void *memory = malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept {
+    free(memory);
+}
+
+namespace {
+
+    const unsigned SEED = 2023;
+
+    /**
+     * @brief Counts hardware cache misses of the calling thread with perf_event_open, when the kernel allows it.
+     */
+    class CacheMissCounter {
+    private:
+        int descriptor;
+
+    public:
+        CacheMissCounter() : descriptor(-1) {
+            perf_event_attr attributes{};
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+
+        ~CacheMissCounter() {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+        }
+
+        bool available() const {
+            return descriptor >= 0;
+        }
+
+        void start() const {
+            if (available()) {
+                ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+
+        long long stop() const {
+            long long count = -1;
+            if (available()) {
+                ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(descriptor, &count, sizeof(count)) != sizeof(count)) {
+                    count = -1;
+                }
+            }
+            return count;
+        }
+
+        CacheMissCounter(const CacheMissCounter &) = delete;
+
+        CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+        CacheMissCounter(CacheMissCounter &&) = delete;
+
+        CacheMissCounter &operator=(CacheMissCounter &&) = delete;
+    };
+
+    string formatMisses(long long misses) {
+        return misses < 0 ? "n/a" : to_string(misses);
+    }
+
+    /**
+     * @brief The Character layout before the hot/cold split, the name stored inline next to the hot fields.
+     */
+    struct LegacyFighter {
+        LegacyFighter(const string &name, const Point &location) : location(location), hitPoints(110), name(name) {}
+
+        virtual ~LegacyFighter() = default;
+
+        LegacyFighter(const LegacyFighter &) = default;
+
+        LegacyFighter &operator=(const LegacyFighter &) = default;
+
+        LegacyFighter(LegacyFighter &&) = default;
+
+        LegacyFighter &operator=(LegacyFighter &&) = default;
+
+        Point location;
+        int hitPoints;
+        string name;
+        bool teamMember = false;
+        int bullets = 6;
+    };
+
+    /**
+     * @brief Nearest living fighter scan over a large roster, legacy inline-name layout against the hot/cold split.
+     */
+    void hotColdSplit() {
+        const size_t roster = 1U << 20U;
+        const int queries = 20;
+        mt19937 random(SEED);
+        uniform_real_distribution<double> coordinate(0, 10000);
+
+        vector<LegacyFighter *> legacy;
+        vector<Character *> fighters;
+        legacy.reserve(roster);
+        fighters.reserve(roster);
+        vector<Point> locations;
+        for (size_t i = 0; i < roster; i++) {
+            locations.emplace_back(coordinate(random), coordinate(random));
+        }
+        for (const Point &location: locations) {
+            legacy.push_back(new LegacyFighter("Tom", location));
+        }
+        for (const Point &location: locations) {
+            fighters.push_back(new Cowboy("Tom", location));
+        }
+        vector<Point> origins;
+        for (int i = 0; i < queries; i++) {
+            origins.emplace_back(coordinate(random), coordinate(random));
+        }
+
+        CacheMissCounter counter;
+        size_t checksum = 0;
+        counter.start();
+        auto begin = chrono::steady_clock::now();
+        for (const Point &origin: origins) {
+            const LegacyFighter *closest = nullptr;
+            double closestDistance = numeric_limits<double>::max();
+            for (const LegacyFighter *fighter: legacy) {
+                if (fighter->hitPoints > 0) {
+                    double distance = origin.distance(fighter->location);
+                    if (distance < closestDistance) {
+                        closest = fighter;
+                        closestDistance = distance;
+                    }
+                }
+            }
+            checksum += reinterpret_cast<size_t>(closest);
+        }
+        double legacyNs = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+        long long legacyMisses = counter.stop();
+
+        Team scanner(new Cowboy("scanner", Point(0, 0)));
+        counter.start();
+        begin = chrono::steady_clock::now();
+        for (const Point &origin: origins) {
+            checksum += reinterpret_cast<size_t>(scanner.findClosestCharacter(origin, fighters));
+        }
+        double splitNs = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+        long long splitMisses = counter.stop();
+
+        const double scans = static_cast<double>(roster) * queries;
+        cout << "hot/cold split, nearest scan over " << roster << " fighters x " << queries << " queries" << endl;
+        cout << "  legacy   sizeof " << sizeof(LegacyFighter) << " B, " << legacyNs / scans << " ns/fighter, cache misses "
+             << formatMisses(legacyMisses) << endl;
+        cout << "  hot/cold sizeof " << sizeof(Cowboy) << " B, " << splitNs / scans << " ns/fighter, cache misses "
+             << formatMisses(splitMisses) << endl;
+        cout << "  (checksum " << checksum % 1000 << ")" << endl;
+
+        for (LegacyFighter *fighter: legacy) {
+            delete fighter;
+        }
+        for (Character *fighter: fighters) {
+            delete fighter;
+        }
+    }
+
+    /**
+     * @brief Accuracy of the float Point variant against the double one on a 1000x1000 board.
+     */
+    void pointAccuracy() {
+        const int samples = 1000000;
+        const double board = 1000;
+        mt19937 random(SEED);
+        uniform_real_distribution<double> coordinate(0, board);
+        uniform_real_distribution<double> step(1, 14);
+
+        double maxDistanceError = 0;
+        double sumDistanceError = 0;
+        double maxMoveError = 0;
+        for (int i = 0; i < samples; i++) {
+            Point first(coordinate(random), coordinate(random));
+            Point second(coordinate(random), coordinate(random));
+            double exact = first.distance(second);
+            double approximate = PointF(first).distance(PointF(second));
+            double error = exact == 0 ? 0 : abs(approximate - exact) / exact;
+            maxDistanceError = max(maxDistanceError, error);
+            sumDistanceError += error;
+
+            double speed = step(random);
+            if (exact > 0) {
+                Point moved = Point::moveTowards(first, second, speed);
+                PointF movedF = PointF::moveTowards(PointF(first), PointF(second), static_cast<float>(speed));
+                maxMoveError = max(maxMoveError, moved.distance(Point(movedF)));
+            }
+        }
+
+        cout << "point accuracy, float vs double, board " << board << "x" << board << endl;
+        cout << "  distance max relative error:  " << scientific << maxDistanceError << endl;
+        cout << "  distance mean relative error: " << sumDistanceError / samples << endl;
+        cout << "  moveTowards max position error: " << maxMoveError << defaultfloat << endl;
+    }
+
+    /**
+     * @brief Results recorded per second by 1 to 64 threads, a mutex protected tally against the sharded aggregator.
+     */
+    void aggregatorScaling() {
+        const int perThread = 200000;
+        BattleResult result;
+        result.winner = BattleWinner::TeamA;
+        result.rounds = 7;
+        result.hitPointsA = 110;
+
+        auto measure = [perThread](size_t threads, const function<void()> &recordOne) {
+            vector<thread> workers;
+            auto begin = chrono::steady_clock::now();
+            for (size_t t = 0; t < threads; t++) {
+                workers.emplace_back([&recordOne, perThread] {
+                    for (int i = 0; i < perThread; i++) {
+                        recordOne();
+                    }
+                });
+            }
+            for (thread &worker: workers) {
+                worker.join();
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            return static_cast<double>(threads) * perThread / seconds;
+        };
+
+        cout << "results aggregator, recorded results per second (" << thread::hardware_concurrency()
+             << " hardware threads)" << endl;
+        cout << "  threads        mutex      sharded" << endl;
+        for (size_t threads = 1; threads <= 64; threads *= 2) {
+            mutex lock;
+            ResultTotals tally;
+            double locked = measure(threads, [&lock, &tally, &result] {
+                lock_guard<mutex> guard(lock);
+                tally.battles++;
+                tally.winsA += result.winner == BattleWinner::TeamA ? 1 : 0;
+                tally.rounds += static_cast<uint64_t>(result.rounds);
+                tally.survivingHitPointsA += static_cast<uint64_t>(result.hitPointsA);
+            });
+            ResultsAggregator aggregator;
+            double sharded = measure(threads, [&aggregator, &result] { aggregator.record(result); });
+            cout << "  " << setw(7) << threads << " " << setw(12) << scientific << setprecision(3) << locked << " "
+                 << setw(12) << sharded << defaultfloat << endl;
+        }
+    }
+
+    /**
+     * @brief A random ten against ten roster, cowboys and all three kinds of ninjas.
+     */
+    Team randomTeam(mt19937 &random, const string &name) {
+        uniform_real_distribution<double> coordinate(0, 1000);
+        uniform_int_distribution<int> kind(0, 3);
+        Team team(new Cowboy(name, Point(coordinate(random), coordinate(random))));
+        for (int i = 1; i < 10; i++) {
+            Point location(coordinate(random), coordinate(random));
+            switch (kind(random)) {
+                case 0:
+                    team.add(new Cowboy(name, location));
+                    break;
+                case 1:
+                    team.add(new YoungNinja(name, location));
+                    break;
+                case 2:
+                    team.add(new TrainedNinja(name, location));
+                    break;
+                default:
+                    team.add(new OldNinja(name, location));
+            }
+        }
+        return team;
+    }
+
+    /**
+     * @brief Thousands of battles one after the other against the same battles interleaved as coroutines.
+     */
+    void coroutineInterleaving() {
+        const int battles = 20000;
+        mt19937 random(SEED);
+        vector<Team> teams;
+        for (int i = 0; i < 2 * battles; i++) {
+            teams.push_back(randomTeam(random, i % 2 == 0 ? "A" : "B"));
+        }
+        vector<Team> copies;
+        for (const Team &team: teams) {
+            copies.push_back(team.clone());
+        }
+
+        auto begin = chrono::steady_clock::now();
+        long long rounds = 0;
+        for (size_t i = 0; i < teams.size(); i += 2) {
+            rounds += runBattle(teams[i], teams[i + 1]).rounds;
+        }
+        double sequential = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+
+        BattleScheduler scheduler;
+        for (size_t i = 0; i < copies.size(); i += 2) {
+            scheduler.add(battleCoroutine(std::move(copies[i]), std::move(copies[i + 1])));
+        }
+        begin = chrono::steady_clock::now();
+        scheduler.run();
+        double interleaved = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+
+        cout << "coroutine interleaving, " << battles << " battles of 10 vs 10, " << rounds << " rounds" << endl;
+        cout << "  sequential  " << sequential / static_cast<double>(rounds) << " ns/round" << endl;
+        cout << "  interleaved " << interleaved / static_cast<double>(rounds) << " ns/round" << endl;
+    }
+
+    /**
+     * @brief Bytes of one battle by component and fighter kind, and how many such battles fit in one GiB.
+     */
+    void memoryFootprint() {
+        const size_t gib = size_t{1} << 30U;
+        const char *kinds[] = {"Cowboy", "YoungNinja", "TrainedNinja", "OldNinja", "Ninja"};
+        mt19937 random(SEED);
+        Team smallA(new Cowboy("A", Point(0, 0)));
+        Team smallB(new OldNinja("B", Point(5, 5)));
+        Team largeA = randomTeam(random, "A");
+        Team largeB = randomTeam(random, "B");
+
+        cout << "memory footprint, bytes (components of team A, total of the whole battle)" << endl;
+        cout << "  battle   team  slots  fighters  vtables  names    total  battles/GiB" << endl;
+        auto report = [gib](const string &label, const Team &teamA, const Team &teamB) {
+            MemoryUsage usage = teamA.memoryUsage();
+            size_t battle = battleBytes(teamA, teamB);
+            cout << "  " << setw(6) << label << " " << setw(6) << usage.team << " " << setw(6) << usage.fighterSlots
+                 << " " << setw(9) << usage.fighters << " " << setw(8) << usage.vtablePointers << " " << setw(6)
+                 << usage.names << " " << setw(8) << battle << " " << setw(12) << gib / battle << endl;
+        };
+        report("1v1", smallA, smallB);
+        report("10v10", largeA, largeB);
+        report("clone", largeA.clone(), largeB.clone());
+
+        MemoryUsage usage = largeA.memoryUsage();
+        for (size_t kind = 0; kind < usage.byType.size(); kind++) {
+            if (usage.byType[kind].count > 0) {
+                cout << "  " << kinds[kind] << ": " << usage.byType[kind].count << " x "
+                     << usage.byType[kind].bytes / usage.byType[kind].count << endl;
+            }
+        }
+    }
+
+    /**
+     * @brief Ninja moves per second toward one victim, Ninja::move one by one against the packed Ninja::moveAll.
+     */
+    void ninjaBatch() {
+        const int steps = 50;
+        cout << "ninja moves toward one victim, ns per move" << endl;
+        cout << "   ninjas  sequential     batched" << endl;
+        for (size_t count: {size_t{16}, size_t{1024}, size_t{65536}}) {
+            mt19937 random(SEED);
+            uniform_real_distribution<double> coordinate(0, 1000);
+            vector<unique_ptr<Ninja>> ninjas;
+            vector<Ninja *> batch;
+            for (size_t i = 0; i < count; i++) {
+                ninjas.push_back(make_unique<YoungNinja>("Yogi", Point(coordinate(random), coordinate(random))));
+                batch.push_back(ninjas.back().get());
+            }
+            vector<Point> start;
+            for (const auto &ninja: ninjas) {
+                start.push_back(ninja->getLocation());
+            }
+            // Far enough that no ninja arrives during the steps.
+            Cowboy victim("Tom", Point(1e6, 1e6));
+
+            auto begin = chrono::steady_clock::now();
+            for (int step = 0; step < steps; step++) {
+                for (const auto &ninja: ninjas) {
+                    ninja->move(&victim);
+                }
+            }
+            double sequential = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            for (size_t i = 0; i < count; i++) {
+                ninjas[i]->setLocation(start[i]);
+            }
+            begin = chrono::steady_clock::now();
+            for (int step = 0; step < steps; step++) {
+                Ninja::moveAll(batch, &victim);
+            }
+            double batched = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            double moves = static_cast<double>(count) * steps;
+            cout << "  " << setw(7) << count << " " << setw(11) << sequential / moves << " " << setw(11)
+                 << batched / moves << endl;
+        }
+    }
+
+    /**
+     * @brief Nearest living cowboy queries at 10, 1k and 100k fighters, linear scan against the k-d tree index.
+     */
+    void kdTree() {
+        const int queries = 2000;
+        cout << "nearest cowboy queries, ns per query" << endl;
+        cout << "  fighters  build (ns)      linear     k-d tree" << endl;
+        for (size_t count: {size_t{10}, size_t{1000}, size_t{100000}}) {
+            mt19937 random(SEED);
+            uniform_real_distribution<double> coordinate(0, 1000);
+            Team team(new Cowboy("Tom", Point(coordinate(random), coordinate(random))), count);
+            for (size_t i = 1; i < count; i++) {
+                team.add(new Cowboy("Tom", Point(coordinate(random), coordinate(random))));
+            }
+            vector<Point> origins;
+            for (int i = 0; i < queries; i++) {
+                origins.emplace_back(coordinate(random), coordinate(random));
+            }
+
+            size_t checksum = 0;
+            auto begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                checksum += reinterpret_cast<uintptr_t>(team.findClosestCharacter(origin, team.getFighters()));
+            }
+            double linear = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+
+            team.setIndexing(Indexing::Spatial);
+            begin = chrono::steady_clock::now();
+            team.findClosestCharacter(origins[0], team.getFighters());
+            double build = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                checksum -= reinterpret_cast<uintptr_t>(team.findClosestCharacter(origin, team.getFighters()));
+            }
+            double indexed = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            cout << "  " << setw(8) << count << " " << setw(11) << build << " " << setw(11) << linear / queries
+                 << " " << setw(12) << indexed / queries << (checksum == 0 ? "" : "  MISMATCH") << endl;
+        }
+    }
+
+    void looseQuadtree() {
+        const int rounds = 20;
+        const int queries = 200;
+        cout << "ninja rosters, every ninja steps then nearest queries, ns per round" << endl;
+        cout << "  fighters      linear    quadtree" << endl;
+        for (size_t count: {size_t{10}, size_t{1000}, size_t{20000}}) {
+            double elapsed[2] = {0, 0};
+            vector<long> picks[2];
+            for (int indexed = 0; indexed < 2; indexed++) {
+                mt19937 random(SEED);
+                uniform_real_distribution<double> coordinate(0, 1000);
+                Team team(new Cowboy("Tom", Point(coordinate(random), coordinate(random))), count);
+                for (size_t i = 1; i < count; i++) {
+                    team.add(new YoungNinja("Yogi", Point(coordinate(random), coordinate(random))));
+                }
+                team.setIndexing(indexed == 1 ? Indexing::Spatial : Indexing::LinearScan);
+                const vector<Character *> &fighters = team.getFighters();
+                team.findClosestCharacter(Point(0, 0), fighters);
+                auto begin = chrono::steady_clock::now();
+                for (int round = 0; round < rounds; round++) {
+                    Cowboy target("Target", Point(coordinate(random), coordinate(random)));
+                    for (size_t i = 1; i < count; i++) {
+                        static_cast<Ninja *>(fighters[i])->move(&target);
+                    }
+                    for (int query = 0; query < queries; query++) {
+                        Point origin(coordinate(random), coordinate(random));
+                        Character *found = team.findClosestCharacter(origin, fighters);
+                        picks[indexed].push_back(find(fighters.begin(), fighters.end(), found) - fighters.begin());
+                    }
+                }
+                elapsed[indexed] = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            }
+            cout << "  " << setw(8) << count << " " << setw(11) << elapsed[0] / rounds << " " << setw(11)
+                 << elapsed[1] / rounds << (picks[0] == picks[1] ? "" : "  MISMATCH") << endl;
+        }
+    }
+
+    void proximityQueries() {
+        const int queries = 200;
+        const size_t k = 16;
+        const double radius = 20;
+        cout << "k nearest (k = " << k << ") and radius (r = " << radius << ") queries, ns per query" << endl;
+        cout << "  fighters   copy+sort   k nearest      radius" << endl;
+        for (size_t count: {size_t{1000}, size_t{100000}}) {
+            mt19937 random(SEED);
+            uniform_real_distribution<double> coordinate(0, 1000);
+            Team team(new Cowboy("Tom", Point(coordinate(random), coordinate(random))), count);
+            for (size_t i = 1; i < count; i++) {
+                if (i % 2 == 0) {
+                    team.add(new Cowboy("Tom", Point(coordinate(random), coordinate(random))));
+                } else {
+                    team.add(new OldNinja("sushi", Point(coordinate(random), coordinate(random))));
+                }
+            }
+            vector<Point> origins;
+            for (int i = 0; i < queries; i++) {
+                origins.emplace_back(coordinate(random), coordinate(random));
+            }
+
+            // What callers had to do before: copy the fighters and sort them by distance.
+            size_t checksum = 0;
+            auto begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                vector<Character *> copy = team.getFighters();
+                partial_sort(copy.begin(), copy.begin() + static_cast<ptrdiff_t>(k), copy.end(),
+                             [&origin](const Character *first, const Character *second) {
+                                 return origin.distance(first->getLocation()) <
+                                        origin.distance(second->getLocation());
+                             });
+                checksum += reinterpret_cast<uintptr_t>(copy[k - 1]);
+            }
+            double sorted = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+
+            team.setIndexing(Indexing::Spatial);
+            array<NearestHit, k> hits{};
+            team.kNearest(origins[0], hits);
+            begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                team.kNearest(origin, hits);
+                checksum -= reinterpret_cast<uintptr_t>(hits[k - 1].fighter);
+            }
+            double nearest = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+
+            size_t visited = 0;
+            begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                team.withinRadius(origin, radius, [&visited](Character *, double) { visited++; });
+            }
+            double within = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            cout << "  " << setw(8) << count << " " << setw(11) << sorted / queries << " " << setw(11)
+                 << nearest / queries << " " << setw(11) << within / queries
+                 << (checksum == 0 ? "" : "  MISMATCH") << "  (" << visited / queries << " in radius)" << endl;
+        }
+    }
+
+    void proximityCache() {
+        const int battles = 2000;
+        cout << "10v10 battles, ns per battle and share of nearest queries answered by the proximity cache" << endl;
+        cout << "  rosters          searched      shared    hit rate" << endl;
+        for (bool cowboysOnly: {false, true}) {
+            double elapsed[2] = {0, 0};
+            size_t hits = 0;
+            size_t queries = 0;
+            for (int share = 0; share < 2; share++) {
+                mt19937 random(SEED);
+                uniform_real_distribution<double> coordinate(0, 1000);
+                vector<pair<Team, Team>> matchups;
+                for (int i = 0; i < battles; i++) {
+                    if (cowboysOnly) {
+                        Team a(new Cowboy("A", Point(coordinate(random), coordinate(random))));
+                        Team b(new Cowboy("B", Point(coordinate(random), coordinate(random))));
+                        for (int j = 1; j < 10; j++) {
+                            a.add(new Cowboy("A", Point(coordinate(random), coordinate(random))));
+                            b.add(new Cowboy("B", Point(coordinate(random), coordinate(random))));
+                        }
+                        matchups.emplace_back(std::move(a), std::move(b));
+                    } else {
+                        Team a = randomTeam(random, "A");
+                        matchups.emplace_back(std::move(a), randomTeam(random, "B"));
+                    }
+                }
+                BattleOptions options;
+                options.shareProximity = share == 1;
+                auto begin = chrono::steady_clock::now();
+                for (auto &matchup: matchups) {
+                    Battle battle(matchup.first, matchup.second, options);
+                    while (!battle.finished()) {
+                        battle.playRound();
+                    }
+                    hits += battle.getProximity().hits();
+                    queries += battle.getProximity().hits() + battle.getProximity().misses();
+                }
+                elapsed[share] = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            }
+            cout << "  " << setw(12) << (cowboysOnly ? "cowboys" : "mixed") << " " << setw(11)
+                 << elapsed[0] / battles << " " << setw(11) << elapsed[1] / battles << " " << setw(10)
+                 << 100.0 * static_cast<double>(hits) / static_cast<double>(queries) << "%" << endl;
+        }
+    }
+
+    void mortonLayout() {
+        const size_t count = 200000;
+        const int queries = 50;
+        cout << "Morton layout, " << count << " fighters added in random order, ns per query" << endl;
+        cout << "  layout         nearest scan   radius (indexed)" << endl;
+        mt19937 random(SEED);
+        uniform_real_distribution<double> coordinate(0, 1000);
+        // Allocated in one order and added in another, like a roster assembled from many sources.
+        vector<Character *> pool;
+        for (size_t i = 0; i < count; i++) {
+            Point location(coordinate(random), coordinate(random));
+            if (i % 2 == 0) {
+                pool.push_back(new Cowboy("Tom", location));
+            } else {
+                pool.push_back(new OldNinja("sushi", location));
+            }
+        }
+        shuffle(pool.begin(), pool.end(), random);
+        Team team(pool[0], count);
+        for (size_t i = 1; i < count; i++) {
+            team.add(pool[i]);
+        }
+        vector<Point> origins;
+        for (int i = 0; i < queries; i++) {
+            origins.emplace_back(coordinate(random), coordinate(random));
+        }
+        for (Layout layout: {Layout::Insertion, Layout::Morton}) {
+            team.setIndexing(Indexing::LinearScan);
+            team.setLayout(layout);
+            size_t checksum = 0;
+            auto begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                checksum += team.findClosestCharacter(origin, team.getFighters())->getNameId();
+            }
+            double scan = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            team.setIndexing(Indexing::Spatial);
+            team.findClosestCharacter(origins[0], team.getFighters());
+            begin = chrono::steady_clock::now();
+            for (const Point &origin: origins) {
+                team.withinRadius(origin, 30, [&checksum](Character *fighter, double) {
+                    checksum += static_cast<size_t>(fighter->getHitPoints());
+                });
+            }
+            double radius = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            cout << "  " << setw(9) << (layout == Layout::Morton ? "morton" : "insertion") << " " << setw(17)
+                 << scan / queries << " " << setw(18) << radius / queries << "  (checksum " << checksum << ")"
+                 << endl;
+        }
+    }
+
+    void approximateRanking() {
+        const int queries = 200;
+        cout << "victim picks by linear scan, ns per pick and share of picks differing from the exact ranking" << endl;
+        cout << "  fighters        exact  approximate    differing" << endl;
+        for (size_t count: {size_t{10}, size_t{1000}, size_t{100000}}) {
+            mt19937 random(SEED);
+            uniform_real_distribution<double> coordinate(0, 1000);
+            Team attackers(new Cowboy("Tom", Point(500, 500)), 1);
+            Team defenders(new Cowboy("Tom", Point(coordinate(random), coordinate(random))), count);
+            for (size_t i = 1; i < count; i++) {
+                defenders.add(new OldNinja("sushi", Point(coordinate(random), coordinate(random))));
+            }
+            vector<Point> origins;
+            for (int i = 0; i < queries; i++) {
+                origins.emplace_back(coordinate(random), coordinate(random));
+            }
+            double elapsed[2] = {0, 0};
+            for (Ranking ranking: {Ranking::Exact, Ranking::Approximate}) {
+                attackers.setRanking(ranking);
+                auto begin = chrono::steady_clock::now();
+                for (const Point &origin: origins) {
+                    attackers.pickTarget(origin, defenders);
+                }
+                elapsed[ranking == Ranking::Exact ? 0 : 1] =
+                        chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            }
+            attackers.setRanking(Ranking::Audited);
+            for (const Point &origin: origins) {
+                attackers.pickTarget(origin, defenders);
+            }
+            RankingStats stats = attackers.getRankingStats();
+            cout << "  " << setw(8) << count << " " << setw(12) << elapsed[0] / queries << " " << setw(12)
+                 << elapsed[1] / queries << " " << setw(11)
+                 << 100.0 * static_cast<double>(stats.mismatches) / static_cast<double>(stats.queries) << "%" << endl;
+        }
+    }
+
+    void distanceMatrix() {
+        const int battles = 2000;
+        cout << "10v10 battles with the proximity cache, ns per battle and share of nearest queries from the matrix"
+             << endl;
+        cout << "  rosters          searched      matrix   answered" << endl;
+        for (bool ninjasOnly: {false, true}) {
+            double elapsed[2] = {0, 0};
+            size_t answers = 0;
+            size_t queries = 0;
+            for (int matrix = 0; matrix < 2; matrix++) {
+                mt19937 random(SEED);
+                uniform_real_distribution<double> coordinate(0, 1000);
+                vector<pair<Team, Team>> matchups;
+                for (int i = 0; i < battles; i++) {
+                    if (ninjasOnly) {
+                        Team a(new OldNinja("A", Point(coordinate(random), coordinate(random))));
+                        Team b(new YoungNinja("B", Point(coordinate(random), coordinate(random))));
+                        for (int j = 1; j < 10; j++) {
+                            a.add(new OldNinja("A", Point(coordinate(random), coordinate(random))));
+                            b.add(new YoungNinja("B", Point(coordinate(random), coordinate(random))));
+                        }
+                        matchups.emplace_back(std::move(a), std::move(b));
+                    } else {
+                        Team a = randomTeam(random, "A");
+                        matchups.emplace_back(std::move(a), randomTeam(random, "B"));
+                    }
+                }
+                BattleOptions options;
+                options.distanceMatrix = matrix == 1;
+                auto begin = chrono::steady_clock::now();
+                for (auto &matchup: matchups) {
+                    Battle battle(matchup.first, matchup.second, options);
+                    while (!battle.finished()) {
+                        battle.playRound();
+                    }
+                    if (matrix == 1) {
+                        answers += battle.getProximity().distances()->answers();
+                        queries += battle.getProximity().hits() + battle.getProximity().misses();
+                    }
+                }
+                elapsed[matrix] = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+            }
+            cout << "  " << setw(12) << (ninjasOnly ? "ninjas" : "mixed") << " " << setw(11)
+                 << elapsed[0] / battles << " " << setw(11) << elapsed[1] / battles << " " << setw(9)
+                 << 100.0 * static_cast<double>(answers) / static_cast<double>(queries) << "%" << endl;
+        }
+    }
+
+    /**
+     * @brief Times creating and destroying n fighters of one kind, on the heap and on the stack.
+     * @return The sum of their hit points, printed so the stack constructions are not optimized away.
+     */
+    template<typename Fighter>
+    long long constructionRow(const string &kind, size_t n) {
+        vector<Character *> fighters(n);
+        size_t before = allocations.load();
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; i++) {
+            fighters[i] = new Fighter("Tom", Point(static_cast<double>(i % 1000), 1));
+        }
+        auto built = chrono::steady_clock::now();
+        size_t allocated = allocations.load() - before;
+        for (Character *fighter: fighters) {
+            delete fighter;
+        }
+        auto destroyed = chrono::steady_clock::now();
+        // Only the constructor and its validation, no allocation of the object itself.
+        long long hitPoints = 0;
+        auto stackBegin = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; i++) {
+            Fighter fighter("Tom", Point(static_cast<double>(i % 1000), 1));
+            hitPoints += fighter.getHitPoints();
+        }
+        auto stackEnd = chrono::steady_clock::now();
+        auto perObject = [n](chrono::steady_clock::time_point from, chrono::steady_clock::time_point to) {
+            return chrono::duration<double, nano>(to - from).count() / static_cast<double>(n);
+        };
+        cout << "  " << setw(12) << kind << " " << setw(9) << perObject(begin, built) << " " << setw(9)
+             << perObject(stackBegin, stackEnd) << " " << setw(9) << perObject(built, destroyed) << " " << setw(8)
+             << static_cast<double>(allocated) / static_cast<double>(n) << endl;
+        return hitPoints;
+    }
+
+    void construction() {
+        const size_t count = 200000;
+        cout << "Fighter lifetime, " << count << " of each kind, ns per fighter and allocations per fighter" << endl;
+        cout << "  fighter            new     stack    delete   allocs" << endl;
+        long long checksum = constructionRow<Cowboy>("Cowboy", count);
+        checksum += constructionRow<YoungNinja>("YoungNinja", count);
+        checksum += constructionRow<TrainedNinja>("TrainedNinja", count);
+        checksum += constructionRow<OldNinja>("OldNinja", count);
+        cout << "  (checksum " << checksum % 1000 << ")" << endl;
+
+        const size_t teams = 20000;
+        cout << "Team lifetime, " << teams << " teams of 10, ns per team and allocations per team" << endl;
+        cout << "  team             build  teardown   allocs" << endl;
+        for (bool cloned: {false, true}) {
+            mt19937 random(SEED);
+            vector<Team> built;
+            built.reserve(teams);
+            vector<Team> sources;
+            if (cloned) {
+                sources.reserve(teams);
+                for (size_t i = 0; i < teams; i++) {
+                    sources.push_back(randomTeam(random, "A"));
+                }
+            }
+            size_t before = allocations.load();
+            auto begin = chrono::steady_clock::now();
+            for (size_t i = 0; i < teams; i++) {
+                built.push_back(cloned ? sources[i].clone() : randomTeam(random, "A"));
+            }
+            auto middle = chrono::steady_clock::now();
+            size_t allocated = allocations.load() - before;
+            built.clear();
+            auto end = chrono::steady_clock::now();
+            cout << "  " << setw(12) << (cloned ? "cloned" : "added") << " " << setw(9)
+                 << chrono::duration<double, nano>(middle - begin).count() / teams << " " << setw(9)
+                 << chrono::duration<double, nano>(end - middle).count() / teams << " " << setw(8)
+                 << static_cast<double>(allocated) / teams << endl;
+        }
+    }
+
+    /**
+     * @brief The samples of one benchmark of the regression section, in ns per operation.
+     */
+    struct Measurement {
+        string name;
+        vector<double> samples;
+        double allocations = 0;
+
+        double percentile(double fraction) const {
+            vector<double> sorted = samples;
+            sort(sorted.begin(), sorted.end());
+            auto rank = static_cast<size_t>(ceil(fraction * static_cast<double>(sorted.size())));
+            return sorted[rank == 0 ? 0 : rank - 1];
+        }
+
+        double median() const {
+            return percentile(0.5);
+        }
+
+        double p95() const {
+            return percentile(0.95);
+        }
+    };
+
+    vector<Measurement> measurements;
+
+    /**
+     * @brief Times ops operations run by work, in ns per operation, and counts their allocations.
+     */
+    template<typename Work>
+    pair<double, double> timed(size_t ops, Work &&work) {
+        size_t before = allocations.load();
+        auto begin = chrono::steady_clock::now();
+        work();
+        double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+        return {elapsed / static_cast<double>(ops), static_cast<double>(allocations.load() - before) /
+                                                    static_cast<double>(ops)};
+    }
+
+    /**
+     * @brief Collects the samples of one benchmark, each sample prepares its own state and times a batch.
+     */
+    void measure(const string &name, const function<pair<double, double>()> &sample) {
+        const int samples = 31;
+        Measurement measurement{name, {}, 0};
+        sample();
+        for (int i = 0; i < samples; i++) {
+            pair<double, double> result = sample();
+            measurement.samples.push_back(result.first);
+            measurement.allocations = result.second;
+        }
+        cout << "  " << setw(14) << name << " " << setw(11) << measurement.median() << " " << setw(11)
+             << measurement.p95() << " " << setw(8) << measurement.allocations << endl;
+        measurements.push_back(std::move(measurement));
+    }
+
+    /**
+     * @brief The hot entry points whose speed the baseline file tracks between revisions.
+     */
+    void regression() {
+        cout << "Regression benchmarks, ns per operation over 31 samples" << endl;
+        cout << "  benchmark           median         p95   allocs" << endl;
+        mt19937 random(SEED);
+        vector<Team> teams;
+        for (int i = 0; i < 100; i++) {
+            teams.push_back(randomTeam(random, i % 2 == 0 ? "A" : "B"));
+        }
+        uniform_real_distribution<double> coordinate(0, 1000);
+        vector<Point> origins;
+        for (int i = 0; i < 1000; i++) {
+            origins.emplace_back(coordinate(random), coordinate(random));
+        }
+
+        measure("attack", [&] {
+            vector<Team> fighting;
+            for (const Team &team: teams) {
+                fighting.push_back(team.clone());
+            }
+            return timed(fighting.size() / 2, [&] {
+                for (size_t i = 0; i + 1 < fighting.size(); i += 2) {
+                    fighting[i].attack(&fighting[i + 1]);
+                }
+            });
+        });
+        measure("find_closest", [&] {
+            size_t checksum = 0;
+            pair<double, double> result = timed(origins.size(), [&] {
+                for (const Point &origin: origins) {
+                    checksum += reinterpret_cast<uintptr_t>(
+                            teams[0].findClosestCharacter(origin, teams[0].getFighters()));
+                }
+            });
+            return checksum == 0 ? pair<double, double>{0, 0} : result;
+        });
+        measure("battle", [&] {
+            vector<Team> fighting;
+            for (const Team &team: teams) {
+                fighting.push_back(team.clone());
+            }
+            return timed(fighting.size() / 2, [&] {
+                for (size_t i = 0; i + 1 < fighting.size(); i += 2) {
+                    runBattle(fighting[i], fighting[i + 1]);
+                }
+            });
+        });
+    }
+
+    /**
+     * @brief The git revision of the working tree, with -dirty when tracked files changed since.
+     */
+    string gitRevision() {
+        auto output = [](const char *command) {
+            string text;
+            if (FILE *pipe = popen(command, "r")) {
+                char buffer[128];
+                while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+                    text += buffer;
+                }
+                pclose(pipe);
+            }
+            return text;
+        };
+        string revision = output("git rev-parse --short HEAD 2>/dev/null");
+        revision.erase(revision.find_last_not_of(" \n") + 1);
+        if (revision.empty()) {
+            return "unknown";
+        }
+        if (!output("git status --porcelain --untracked-files=no 2>/dev/null").empty()) {
+            revision += "-dirty";
+        }
+        return revision;
+    }
+
+    /**
+     * @brief A stored result: one line per benchmark and revision,
+     * "<revision> <name> <median> <p95> <allocations> <sample>,<sample>,...".
+     */
+    struct Baseline {
+        string revision;
+        Measurement measurement;
+    };
+
+    vector<Baseline> loadBaselines(const string &path) {
+        vector<Baseline> baselines;
+        ifstream file(path);
+        string line;
+        while (getline(file, line)) {
+            istringstream fields(line);
+            Baseline baseline;
+            double median = 0;
+            double p95 = 0;
+            string samples;
+            if (!(fields >> baseline.revision >> baseline.measurement.name >> median >> p95 >>
+                         baseline.measurement.allocations >> samples)) {
+                continue;
+            }
+            istringstream values(samples);
+            string value;
+            while (getline(values, value, ',')) {
+                baseline.measurement.samples.push_back(stod(value));
+            }
+            if (!baseline.measurement.samples.empty()) {
+                baselines.push_back(std::move(baseline));
+            }
+        }
+        return baselines;
+    }
+
+    /**
+     * @brief Stores the measurements under a revision, replacing what was stored for the same revision.
+     */
+    void saveBaselines(const string &path, const string &revision) {
+        vector<Baseline> baselines = loadBaselines(path);
+        for (const Measurement &measurement: measurements) {
+            baselines.erase(remove_if(baselines.begin(), baselines.end(), [&](const Baseline &baseline) {
+                return baseline.revision == revision && baseline.measurement.name == measurement.name;
+            }), baselines.end());
+            baselines.push_back({revision, measurement});
+        }
+        ofstream file(path, ios::trunc);
+        for (const Baseline &baseline: baselines) {
+            const Measurement &measurement = baseline.measurement;
+            file << baseline.revision << " " << measurement.name << " " << measurement.median() << " "
+                 << measurement.p95() << " " << measurement.allocations << " ";
+            for (size_t i = 0; i < measurement.samples.size(); i++) {
+                file << (i == 0 ? "" : ",") << measurement.samples[i];
+            }
+            file << "\n";
+        }
+        cout << "saved " << measurements.size() << " results of " << revision << " to " << path << endl;
+    }
+
+    /**
+     * @brief Mann-Whitney U test of current against baseline, with the normal approximation.
+     * @return The z score, large and positive when current is slower.
+     */
+    double slowerScore(const vector<double> &baseline, const vector<double> &current) {
+        vector<pair<double, bool>> pooled;
+        for (double sample: baseline) {
+            pooled.emplace_back(sample, false);
+        }
+        for (double sample: current) {
+            pooled.emplace_back(sample, true);
+        }
+        sort(pooled.begin(), pooled.end());
+        // Sum of the ranks of the current samples, tied samples share their average rank.
+        double rankSum = 0;
+        for (size_t i = 0; i < pooled.size();) {
+            size_t j = i;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+                j++;
+            }
+            double rank = static_cast<double>(i + j + 1) / 2;
+            for (size_t k = i; k < j; k++) {
+                rankSum += pooled[k].second ? rank : 0;
+            }
+            i = j;
+        }
+        auto first = static_cast<double>(baseline.size());
+        auto second = static_cast<double>(current.size());
+        double u = rankSum - second * (second + 1) / 2;
+        return (u - first * second / 2) / sqrt(first * second * (first + second + 1) / 12);
+    }
+
+    /**
+     * @brief Compares the measurements with the most recent stored result of each benchmark.
+     * A benchmark regressed when it is slower with p < 0.01 (one sided) and its median grew by more than 5%.
+     * @return The number of regressions.
+     */
+    int compareBaselines(const string &path) {
+        const double significant = 2.326;
+        const double tolerance = 1.05;
+        vector<Baseline> baselines = loadBaselines(path);
+        int regressions = 0;
+        cout << "Compared with " << path << endl;
+        cout << "  benchmark      revision             before       after   change        z  verdict" << endl;
+        for (const Measurement &measurement: measurements) {
+            auto stored = find_if(baselines.rbegin(), baselines.rend(), [&](const Baseline &baseline) {
+                return baseline.measurement.name == measurement.name;
+            });
+            if (stored == baselines.rend()) {
+                cout << "  " << setw(14) << left << measurement.name << right << " no stored result" << endl;
+                continue;
+            }
+            double before = stored->measurement.median();
+            double after = measurement.median();
+            double z = slowerScore(stored->measurement.samples, measurement.samples);
+            const char *verdict = "same";
+            if (z > significant && after > before * tolerance) {
+                verdict = "REGRESSION";
+                regressions++;
+            } else if (z < -significant && before > after * tolerance) {
+                verdict = "faster";
+            }
+            cout << "  " << setw(14) << left << measurement.name << right << " " << setw(14) << stored->revision
+                 << " " << setw(12) << before << " " << setw(11) << after << " " << setw(7) << fixed
+                 << setprecision(1) << 100 * (after / before - 1) << "% " << setw(8) << setprecision(2) << z
+                 << defaultfloat << setprecision(6) << "  " << verdict << endl;
+        }
+        return regressions;
+    }
+
+    const map<string, function<void()>> SECTIONS = {
+            {"point_accuracy", pointAccuracy},
+            {"hot_cold", hotColdSplit},
+            {"aggregator", aggregatorScaling},
+            {"coroutines", coroutineInterleaving},
+            {"memory", memoryFootprint},
+            {"ninja_batch", ninjaBatch},
+            {"kd_tree", kdTree},
+            {"loose_quadtree", looseQuadtree},
+            {"proximity_queries", proximityQueries},
+            {"proximity_cache", proximityCache},
+            {"morton_layout", mortonLayout},
+            {"approximate_ranking", approximateRanking},
+            {"distance_matrix", distanceMatrix},
+            {"construction", construction},
+            {"regression", regression},
+    };
+}
+
+int main(int argc, char **argv) {
+    vector<string> selected;
+    bool save = false;
+    bool compare = false;
+    string baselinePath = "bench_baseline.txt";
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--save") {
+            save = true;
+        } else if (argument == "--compare") {
+            compare = true;
+        } else if (argument == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else {
+            selected.push_back(argument);
+        }
+    }
+    if (selected.empty()) {
+        if (save || compare) {
+            selected.emplace_back("regression");
+        } else {
+            for (const auto &section: SECTIONS) {
+                selected.push_back(section.first);
+            }
+        }
+    }
+    for (const string &name: selected) {
+        auto section = SECTIONS.find(name);
+        if (section == SECTIONS.end()) {
+            cerr << "unknown section: " << name << endl;
+            return 1;
+        }
+        section->second();
+    }
+    int regressions = compare ? compareBaselines(baselinePath) : 0;
+    if (save) {
+        saveBaselines(baselinePath, gitRevision());
+    }
+    return regressions > 0 ? 2 : 0;
+}
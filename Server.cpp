@@ -0,0 +1,41 @@
+/**
+ * @file Server.cpp
+ * @brief Runs the battle simulation server until SIGINT or SIGTERM, then prints its latency percentiles.
+ * Usage: ./server <socket path> [threads]
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include <csignal>
+#include <iostream>
+#include <string>
+
+#include "sources/SimulationServer.hpp"
+
+using namespace std;
+using namespace ariel;
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Usage: " << argv[0] << " <socket path> [threads]" << endl;
+        return 1;
+    }
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    // Blocked before any thread starts, so only the sigwait below receives them.
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    ThreadPool pool(argc == 3 ? stoul(argv[2]) : 0);
+    SimulationServer server(argv[1], pool);
+    server.start();
+    cout << "Listening on " << argv[1] << " with " << pool.size() << " threads" << endl;
+
+    int received = 0;
+    sigwait(&signals, &received);
+    server.stop();
+    cout << "Served " << server.requestsServed() << " requests, p50 " << server.latencyPercentile(0.5)
+         << " us, p99 " << server.latencyPercentile(0.99) << " us" << endl;
+    return 0;
+}
@@ -9,11 +9,57 @@
 #include "sources/Character.hpp"
 #include "sources/Point.hpp"
 #include "sources/Team.hpp"
+#include "sources/Battle.hpp"
+#include "sources/Tournament.hpp"
+#include "sources/WinRate.hpp"
+#include "sources/Profiler.hpp"
+#include "sources/FixedPoint.hpp"
+#include "sources/TeamTemplate.hpp"
+#include "sources/ResultsAggregator.hpp"
+#include "sources/BattleCoroutine.hpp"
+#include "sources/SimulationServer.hpp"
+#include "sources/MemoryBudget.hpp"
+#include "sources/LooseQuadtree.hpp"
+#include "sources/ProximityCache.hpp"
+#include "sources/DistanceMatrix.hpp"
 #include <bits/stdc++.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace ariel;
 
+namespace {
+    /**
+     * @brief A team of random fighters led by a cowboy. The same seed gives the same team.
+     * @param size The number of fighters, the capacity is at least the default one.
+     * @param cowboysOnly Only cowboys, otherwise every kind is equally likely.
+     * @param extent The fighters stand on whole coordinates between 0 and extent.
+     */
+    Team randomTeam(std::mt19937 &rng, std::size_t size, bool cowboysOnly = false, int extent = 60) {
+        std::uniform_int_distribution<int> coordinate(0, extent);
+        std::uniform_int_distribution<int> kind(0, 3);
+        auto randomPoint = [&] { return Point(coordinate(rng), coordinate(rng)); };
+        Team team(new Cowboy("Leader", randomPoint()), std::max(size, Team::DEFAULT_CAPACITY));
+        for (std::size_t i = 1; i < size; i++) {
+            switch (cowboysOnly ? 0 : kind(rng)) {
+                case 0:
+                    team.add(new Cowboy("Tom", randomPoint()));
+                    break;
+                case 1:
+                    team.add(new YoungNinja("Yogi", randomPoint()));
+                    break;
+                case 2:
+                    team.add(new TrainedNinja("Hiro", randomPoint()));
+                    break;
+                default:
+                    team.add(new OldNinja("sushi", randomPoint()));
+                    break;
+            }
+        }
+        return team;
+    }
+}
+
 ///@test Point.hpp
 
 TEST_CASE("Test Case 1: Creating a Point object") {
@@ -285,9 +331,1249 @@ TEST_CASE("Test Case 12: Ninja Move and Slash") {
 
 }
 
+///@test Battle.hpp
+
+TEST_CASE("Test Case 13: runBattle plays until one team is eliminated") {
+    Team team_A(new Cowboy("Tom", Point(32.3, 44)));
+    team_A.add(new YoungNinja("Yogi", Point(64, 57)));
+    Team team_B(new OldNinja("sushi", Point(1.3, 3.5)));
+    team_B.add(new TrainedNinja("Hikari", Point(12, 81)));
+
+    BattleResult result = runBattle(team_A, team_B);
+    CHECK(result.rounds > 0);
+    CHECK(result.survivorsA == team_A.stillAlive());
+    CHECK(result.survivorsB == team_B.stillAlive());
+    CHECK((result.survivorsA == 0) != (result.survivorsB == 0));
+    CHECK(result.winner == (result.survivorsA > 0 ? BattleWinner::TeamA : BattleWinner::TeamB));
+    // every hit point lost by a team was dealt by the other one
+    CHECK(result.damageDealtA == 150 + 120 - (team_B.getFighters()[0]->getHitPoints() +
+                                              team_B.getFighters()[1]->getHitPoints()));
+    CHECK(result.damageDealtB == 110 + 100 - (team_A.getFighters()[0]->getHitPoints() +
+                                              team_A.getFighters()[1]->getHitPoints()));
+}
+
+TEST_CASE("Test Case 14: runBattle respects the round limit") {
+    Team team_A(new Cowboy("Tom", Point(0, 0)));
+    Team team_B(new Cowboy("Jerry", Point(10, 10)));
+
+    BattleOptions options;
+    options.maxRounds = 2;
+    BattleResult result = runBattle(team_A, team_B, options);
+    CHECK(result.rounds == 2);
+    CHECK(result.winner == BattleWinner::None);
+    CHECK(result.damageDealtA == 20);
+    CHECK(result.damageDealtB == 20);
+    CHECK_THROWS(runBattle(team_A, team_A));
+}
+
+///@test Tournament.hpp
+
+TEST_CASE("Test Case 15: round robin tournament on the thread pool") {
+    std::vector<TeamFactory> factories = {
+            [] { return Team(new Cowboy("Tom", Point(0, 0))); },
+            [] {
+                Team team(new OldNinja("sushi", Point(5, 5)));
+                team.add(new YoungNinja("Yogi", Point(6, 6)));
+                return team;
+            },
+            [] { return Team(new TrainedNinja("Hikari", Point(50, 50))); }
+    };
+    TournamentOptions options;
+    options.repetitions = 3;
+    ThreadPool pool(4);
+    TournamentResult result = runTournament(factories, options, pool);
+
+    for (std::size_t first = 0; first < 3; first++) {
+        CHECK(result.battles[first][first] == 0);
+        for (std::size_t second = 0; second < 3; second++) {
+            if (first != second) {
+                CHECK(result.battles[first][second] == 3);
+                // battles are deterministic, so every repetition has the same outcome
+                CHECK((result.winRate(first, second) == 0.0 || result.winRate(first, second) == 1.0));
+            }
+        }
+    }
+    CHECK(result.winRate(1, 0) == 1.0);
+
+    std::vector<TeamFactory> broken = factories;
+    broken.emplace_back([]() -> Team { throw std::runtime_error("broken factory"); });
+    CHECK_THROWS(runTournament(broken, options, pool));
+
+    // callers sharing the pool only wait for, and only see the errors of, their own battles
+    bool threw = false;
+    std::thread failing([&] {
+        try {
+            runTournament(broken, options, pool);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+    });
+    TournamentResult concurrent;
+    CHECK_NOTHROW(concurrent = runTournament(factories, options, pool));
+    failing.join();
+    CHECK(threw);
+    CHECK(concurrent.wins == result.wins);
+
+    // a tournament started from a worker runs the queued battles itself instead of blocking the only worker
+    ThreadPool single(1);
+    TournamentResult nested;
+    ThreadPool::TaskGroup outer(single);
+    outer.submit([&] { nested = runTournament(factories, options, single); });
+    CHECK_NOTHROW(outer.wait());
+    CHECK(nested.wins == result.wins);
+}
+
+///@test WinRate.hpp
+
+TEST_CASE("Test Case 16: win rate estimation stops early") {
+    TeamFactory ninjas = [] {
+        Team team(new OldNinja("sushi", Point(5, 5)));
+        team.add(new YoungNinja("Yogi", Point(6, 6)));
+        return team;
+    };
+    TeamFactory cowboy = [] { return Team(new Cowboy("Tom", Point(0, 0))); };
+
+    WinRateOptions options;
+    options.maxBattles = 1000;
+    options.rule = StoppingRule::Fixed;
+    WinRateEstimate fixed = estimateWinRate(ninjas, cowboy, options);
+    CHECK(fixed.battles == 1000);
+    CHECK(fixed.saved == 0);
+    CHECK(fixed.winRate == 1.0);
+
+    options.rule = StoppingRule::ConfidenceWidth;
+    WinRateEstimate interval = estimateWinRate(ninjas, cowboy, options);
+    CHECK(interval.battles < 1000);
+    CHECK(interval.saved == 1000 - interval.battles);
+    CHECK(interval.upper - interval.lower <= 2 * options.halfWidth);
+
+    options.rule = StoppingRule::Sprt;
+    ThreadPool pool(2);
+    WinRateEstimate sprt = estimateWinRate(cowboy, ninjas, options, &pool);
+    CHECK(sprt.decision == SprtDecision::AcceptLow);
+    CHECK(sprt.battles == options.minBattles + 2);
+
+    options.p0 = 0.7;
+    options.p1 = 0.6;
+    CHECK_THROWS(estimateWinRate(ninjas, cowboy, options));
+}
+
+///@test Profiler.hpp
+
+TEST_CASE("Test Case 17: phase profiler histograms") {
+    PhaseProfiler::reset();
+    PhaseProfiler::record(Phase::NinjaPhase, 0);
+    PhaseProfiler::record(Phase::NinjaPhase, 100);
+    PhaseProfiler::record(Phase::NinjaPhase, 1000);
+    {
+        ScopedPhaseTimer timer(Phase::CowboyPhase);
+    }
+    CHECK(PhaseProfiler::samples(Phase::NinjaPhase) == 3);
+    CHECK(PhaseProfiler::totalTicks(Phase::NinjaPhase) == 1100);
+    CHECK(PhaseProfiler::percentile(Phase::NinjaPhase, 0.5) == 127);
+    CHECK(PhaseProfiler::percentile(Phase::NinjaPhase, 0.99) == 1023);
+    CHECK(PhaseProfiler::samples(Phase::CowboyPhase) == 1);
+    CHECK(PhaseProfiler::json().find("\"ninja_phase\":{\"samples\":3") != std::string::npos);
+    PhaseProfiler::reset();
+    CHECK(PhaseProfiler::samples(Phase::NinjaPhase) == 0);
+}
+
+///@test Point.hpp float variant
+
+TEST_CASE("Test Case 18: float points") {
+    PointF p1(2.0F, 3.0F);
+    PointF p2(5.0F, 7.0F);
+    CHECK(p1.distance(p2) == 5.0F);
+    PointF moved = PointF::moveTowards(p1, p2, 2.5F);
+    CHECK(moved.getX() == doctest::Approx(3.5));
+    CHECK(moved.getY() == doctest::Approx(5.0));
+    CHECK(Point(p2).getX() == 5.0);
+}
+
+///@test FixedPoint.hpp
+
+TEST_CASE("Test Case 19: fixed point positions and deterministic movement") {
+    FixedPoint p1(2.0, 3.0);
+    FixedPoint p2(5.0, 7.0);
+    CHECK(p1.getRawX() == 2 * FixedPoint::ONE);
+    CHECK(p1.squaredDistance(p2) == 25LL * FixedPoint::ONE * FixedPoint::ONE);
+    CHECK(p1.distance(p2) == 5 * FixedPoint::ONE);
+    CHECK(FixedPoint::isqrt(99) == 9);
+    CHECK(FixedPoint::isqrt(100) == 10);
+    CHECK(FixedPoint::moveTowards(p1, p2, 10 * FixedPoint::ONE) == p2);
+    FixedPoint moved = FixedPoint::moveTowards(p1, p2, 2 * FixedPoint::ONE);
+    CHECK(moved.toPoint().getX() == doctest::Approx(3.2).epsilon(1e-4));
+    CHECK(moved.toPoint().getY() == doctest::Approx(4.6).epsilon(1e-4));
+    CHECK_THROWS(FixedPoint(20000.0, 0.0));
+    CHECK_THROWS(FixedPoint::moveTowards(p1, p1, FixedPoint::ONE));
+    Cowboy still("Tom", Point(10, 0));
+    Ninja fastest("Kenji", Point(0, 0), FixedPoint::LIMIT, 100);
+    fastest.moveDeterministic(&still);
+    CHECK(fastest.getLocation().getX() == 10);
+    Ninja tooFast("Kenji", Point(0, 0), 20000, 100);
+    CHECK_THROWS_AS(tooFast.moveDeterministic(&still), std::out_of_range);
+    CHECK(tooFast.getLocation().getX() == 0);
+
+    auto play = [](Point &last) {
+        Team team_A(new Cowboy("Tom", Point(32.3, 44)));
+        team_A.add(new YoungNinja("Yogi", Point(64, 57)));
+        Team team_B(new OldNinja("sushi", Point(1.3, 3.5)));
+        team_B.add(new TrainedNinja("Hikari", Point(12, 81)));
+        team_A.setMovement(Movement::Deterministic);
+        team_B.setMovement(Movement::Deterministic);
+        BattleResult result = runBattle(team_A, team_B);
+        last = team_B.getFighters()[1]->getLocation();
+        return result;
+    };
+    Point first(0, 0);
+    Point second(0, 0);
+    BattleResult resultFirst = play(first);
+    BattleResult resultSecond = play(second);
+    CHECK(resultFirst.rounds == resultSecond.rounds);
+    CHECK(first.getX() == second.getX());
+    CHECK(first.getY() == second.getY());
+    // every ninja step lands on the 1/65536 grid
+    CHECK(std::ldexp(first.getX(), FixedPoint::FRACTION_BITS) == std::round(std::ldexp(first.getX(), FixedPoint::FRACTION_BITS)));
+}
+
+///@test NamePool.hpp
+
+TEST_CASE("Test Case 20: character names are interned in the name pool") {
+    Cowboy tom("Tom", Point(1, 2));
+    YoungNinja yogi("Yogi", Point(3, 4));
+    std::size_t known = NamePool::size();
+    Cowboy anotherTom("Tom", Point(5, 6));
+    CHECK(NamePool::size() == known);
+    CHECK(tom.getName() == "Tom");
+    CHECK(anotherTom.getName() == "Tom");
+    CHECK(yogi.getName() == "Yogi");
+    CHECK(NamePool::intern("Tom") == NamePool::intern(std::string("Tom")));
+    CHECK(&NamePool::text(NamePool::intern("Tom")) == &NamePool::text(NamePool::intern("Tom")));
+    CHECK(NamePool::text(NamePool::intern("Kenshin")) == "Kenshin");
+    CHECK(NamePool::size() == known + 1);
+    CHECK_THROWS(NamePool::text(static_cast<NameId>(NamePool::size())));
+
+    std::size_t before = NamePool::size();
+    CHECK_THROWS_AS(Cowboy("Rejected cowboy", Point(-1, 0)), std::invalid_argument);
+    CHECK_THROWS_AS(Ninja("Rejected ninja", Point(0, 0), 5, 151), std::out_of_range);
+    CHECK_THROWS_AS(Ninja("Rejected ninja", Point(0, 0), -1, 100), std::invalid_argument);
+    CHECK(NamePool::size() == before);
+
+    Cowboy copy(tom);
+    CHECK(copy.getName() == "Tom");
+    CHECK(sizeof(Cowboy) <= 32);
+    CHECK(sizeof(OldNinja) <= 32);
+    CHECK_THROWS_AS(Ninja("Kenji", Point(0, 0), INT16_MAX + 1, 100), std::out_of_range);
+    CHECK(copy.isTeamMember() == tom.isTeamMember());
+    CHECK(copy.getNameId() == tom.getNameId());
+}
+
+///@test Team.hpp move semantics
+
+TEST_CASE("Test Case 21: moving teams transfers the fighters and the leader") {
+    Character *tom = new Cowboy("Tom", Point(0, 0));
+    Character *yogi = new YoungNinja("Yogi", Point(3, 4));
+    Team original(tom);
+    original.add(yogi);
+
+    Team moved(std::move(original));
+    CHECK(moved.getLeader() == tom);
+    CHECK(moved.getFighters().size() == 2);
+    CHECK(original.getLeader() == nullptr);
+    CHECK(original.getFighters().empty());
+    CHECK(original.stillAlive() == 0);
+    // a moved from team takes no fighter, so it never attacks with a null leader
+    Character *late = new Cowboy("Late", Point(5, 5));
+    CHECK_THROWS_AS(original.add(late), std::runtime_error);
+    CHECK_FALSE(late->isTeamMember());
+    CHECK(original.getFighters().empty());
+    CHECK_THROWS_AS(original.attack(&moved), std::runtime_error);
+    delete late;
+
+    std::vector<Team> teams;
+    teams.push_back(std::move(moved));
+    teams.emplace_back(new Cowboy("Jerry", Point(10, 10)));
+    CHECK(teams[0].getLeader() == tom);
+    CHECK(teams[1].getLeader()->getName() == "Jerry");
+
+    Team assigned(new OldNinja("sushi", Point(1, 1)));
+    assigned = std::move(teams[0]);
+    CHECK(assigned.getLeader() == tom);
+    CHECK(assigned.stillAlive() == 2);
+    CHECK_THROWS(assigned.attack(&teams[0]));
+}
+
+TEST_CASE("Test Case 22: cloning a team from a prototype") {
+    Team prototype(new Cowboy("Tom", Point(32.3, 44)));
+    prototype.add(new YoungNinja("Yogi", Point(64, 57)));
+    prototype.add(new OldNinja("sushi", Point(1.3, 3.5)));
+    Team enemies(new TrainedNinja("Hikari", Point(12, 81)));
+
+    Team copy = prototype.clone();
+    CHECK(copy.getFighters().size() == 3);
+    CHECK(copy.getLeader() == copy.getFighters()[0]);
+    CHECK(copy.getLeader() != prototype.getLeader());
+    CHECK(copy.getLeader()->getName() == "Tom");
+    CHECK(dynamic_cast<YoungNinja *>(copy.getFighters()[1]) != nullptr);
+    CHECK(dynamic_cast<OldNinja *>(copy.getFighters()[2]) != nullptr);
+    CHECK(copy.getFighters()[2]->isTeamMember());
+
+    Team enemiesCopy = enemies.clone();
+    BattleResult cloned = runBattle(copy, enemiesCopy);
+    CHECK(prototype.stillAlive() == 3);
+    CHECK(enemies.stillAlive() == 1);
+    BattleResult original = runBattle(prototype, enemies);
+    CHECK(cloned.rounds == original.rounds);
+    CHECK(cloned.damageDealtA == original.damageDealtA);
+
+    copy.add(new Cowboy("Late", Point(1, 1)));
+    CHECK(copy.getFighters().size() == 4);
+
+    std::mt19937 random(7);
+    Team jittered = prototype.clone(0.5, random);
+    for (std::size_t i = 0; i < 3; i++) {
+        CHECK(jittered.getFighters()[i]->distance(prototype.getFighters()[i]) <= std::sqrt(0.5));
+    }
+    CHECK_THROWS(prototype.clone(-1, random));
+}
+
+///@test TeamTemplate.hpp
+
+TEST_CASE("Test Case 23: copy on write team variants") {
+    Team prototype(new Cowboy("Tom", Point(32.3, 44)));
+    prototype.add(new YoungNinja("Yogi", Point(64, 57)));
+    prototype.add(new OldNinja("sushi", Point(1.3, 3.5)));
+    TeamTemplate base(std::move(prototype));
+
+    TeamVariant same = base.variant();
+    TeamVariant moved = base.variant();
+    moved.setLocation(1, Point(10, 10));
+    TeamVariant retyped = base.variant();
+    retyped.replace(0, [] { return new TrainedNinja("Hikari", Point(5, 5)); });
+
+    CHECK(same.overrideCount() == 0);
+    CHECK(moved.overrideCount() == 1);
+    CHECK(moved.location(1).getX() == 10);
+    CHECK(same.location(1).getX() == 64);
+    CHECK(base.prototype().getFighters()[1]->getLocation().getX() == 64);
+    CHECK_THROWS(moved.setLocation(3, Point(1, 1)));
+
+    Team fromMoved = moved.materialize();
+    CHECK(fromMoved.getFighters()[1]->getLocation().getX() == 10);
+    Team fromRetyped = retyped.materialize();
+    CHECK(dynamic_cast<TrainedNinja *>(fromRetyped.getLeader()) != nullptr);
+    CHECK(fromRetyped.getLeader() == fromRetyped.getFighters()[0]);
+    CHECK(fromRetyped.getLeader()->getName() == "Hikari");
+
+    Team enemies(new Cowboy("Jerry", Point(20, 20)));
+    runBattle(fromMoved, enemies);
+    CHECK(base.prototype().stillAlive() == 3);
+    CHECK(moved.materialize().stillAlive() == 3);
+}
+
+///@test ResultsAggregator.hpp
+
+TEST_CASE("Test Case 24: sharded results aggregator") {
+    ResultsAggregator aggregator(8);
+    BattleResult result;
+    result.winner = BattleWinner::TeamB;
+    result.rounds = 3;
+    result.hitPointsB = 50;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; t++) {
+        threads.emplace_back([&aggregator, &result] {
+            for (int i = 0; i < 1000; i++) {
+                aggregator.record(result);
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    ResultTotals totals = aggregator.snapshot();
+    CHECK(totals.battles == 16000);
+    CHECK(totals.winsB == 16000);
+    CHECK(totals.winsA == 0);
+    CHECK(totals.rounds == 48000);
+    CHECK(totals.survivingHitPointsB == 800000);
+    aggregator.reset();
+    CHECK(aggregator.snapshot().battles == 0);
+
+    std::vector<TeamFactory> factories = {
+            [] { return Team(new Cowboy("Tom", Point(0, 0))); },
+            [] { return Team(new OldNinja("sushi", Point(5, 5))); }
+    };
+    TournamentOptions options;
+    options.repetitions = 5;
+    options.results = &aggregator;
+    ThreadPool pool(3);
+    runTournament(factories, options, pool);
+    CHECK(aggregator.snapshot().battles == 10);
+}
+
+///@test BattleCoroutine.hpp
+
+TEST_CASE("Test Case 25: coroutine battles interleaved by the scheduler") {
+    auto makeA = [] {
+        Team team(new Cowboy("Tom", Point(32.3, 44)));
+        team.add(new YoungNinja("Yogi", Point(64, 57)));
+        return team;
+    };
+    auto makeB = [] {
+        Team team(new OldNinja("sushi", Point(1.3, 3.5)));
+        team.add(new TrainedNinja("Hikari", Point(12, 81)));
+        return team;
+    };
+    Team teamA = makeA();
+    Team teamB = makeB();
+    BattleResult expected = runBattle(teamA, teamB);
+
+    BattleTask single = battleCoroutine(makeA(), makeB());
+    int steps = 0;
+    while (single.step()) {
+        steps++;
+    }
+    CHECK(steps == expected.rounds);
+    CHECK(single.result().rounds == expected.rounds);
+    CHECK(single.result().winner == expected.winner);
+
+    BattleScheduler scheduler;
+    for (int i = 0; i < 50; i++) {
+        scheduler.add(battleCoroutine(makeA(), makeB()));
+    }
+    BattleOptions quick;
+    quick.maxRounds = 1;
+    scheduler.add(battleCoroutine(makeA(), makeB(), quick));
+    CHECK(scheduler.inFlight() == 51);
+    scheduler.run();
+    CHECK(scheduler.inFlight() == 0);
+    REQUIRE(scheduler.getResults().size() == 51);
+    CHECK(scheduler.getResults()[0].rounds == 1);
+    CHECK(scheduler.getResults()[50].damageDealtA == expected.damageDealtA);
+
+    BattleTask finished = battleCoroutine(makeA(), makeB(), quick);
+    CHECK_THROWS(finished.result());
+    while (finished.step()) {
+    }
+    CHECK_THROWS(scheduler.add(std::move(finished)));
+}
+
+///@test SimulationServer.hpp
+
+TEST_CASE("Test Case 26: simulation server over a Unix domain socket") {
+    TeamSpec cowboys;
+    cowboys.fighters = {{FighterKind::Cowboy, 32.3, 44, 0},
+                        {FighterKind::YoungNinja, 64, 57, 0}};
+    TeamSpec ninjas;
+    ninjas.leader = 1;
+    ninjas.fighters = {{FighterKind::TrainedNinja, 12, 81, 0},
+                       {FighterKind::OldNinja, 1.3, 3.5, 50}};
+    Scenario full{cowboys, ninjas, BattleOptions(), Movement::FloatingPoint};
+    Scenario shortBattle{ninjas, cowboys, BattleOptions(), Movement::Deterministic};
+    shortBattle.options.maxRounds = 2;
+
+    Team built = Protocol::buildTeam(ninjas);
+    CHECK(built.stillAlive() == 2);
+    CHECK(built.getLeader()->getName() == "OldNinja");
+    CHECK_THROWS(Protocol::buildTeam(TeamSpec()));
+    TeamSpec custom;
+    custom.fighters = {{FighterKind::Ninja, 5, 5, 0}};
+    CHECK_THROWS_AS(Protocol::buildTeam(custom), std::runtime_error);
+    custom.fighters[0].kind = FighterKind::Count;
+    CHECK_THROWS_AS(Protocol::buildTeam(custom), std::runtime_error);
+    custom.fighters[0].kind = FighterKind::Ninja;
+    std::vector<std::uint8_t> customFrame = Protocol::encodeRequest({{custom, cowboys, BattleOptions(),
+                                                                      Movement::FloatingPoint}});
+    std::vector<std::uint8_t> customPayload(customFrame.begin() + Protocol::HEADER_SIZE, customFrame.end());
+    CHECK_THROWS_AS(Protocol::decodeRequest(customPayload), std::runtime_error);
+    std::vector<std::uint8_t> frame = Protocol::encodeRequest({full, shortBattle});
+    CHECK(Protocol::payloadLength(frame.data(), Protocol::REQUEST_MAGIC) == frame.size() - Protocol::HEADER_SIZE);
+    CHECK_THROWS(Protocol::payloadLength(frame.data(), Protocol::RESPONSE_MAGIC));
+    std::vector<std::uint8_t> payload(frame.begin() + Protocol::HEADER_SIZE, frame.end());
+    CHECK(Protocol::decodeRequest(payload)[1].teamA.fighters[1].hitPoints == 50);
+    payload.pop_back();
+    CHECK_THROWS(Protocol::decodeRequest(payload));
+    // the scenario count is checked before any scenario is read
+    std::vector<std::uint8_t> flood = {0, 0, 0, 0};
+    for (std::size_t i = 0; i < 4; i++) {
+        flood[i] = static_cast<std::uint8_t>((Protocol::MAX_SCENARIOS + 1) >> (8 * i));
+    }
+    CHECK_THROWS_WITH_AS(Protocol::decodeRequest(flood), "Error: Too many scenarios in one request.",
+                         std::runtime_error);
+    CHECK_THROWS_AS(Protocol::encodeRequest(std::vector<Scenario>(Protocol::MAX_SCENARIOS + 1, full)),
+                    std::invalid_argument);
+
+    Team teamA = Protocol::buildTeam(cowboys);
+    Team teamB = Protocol::buildTeam(ninjas);
+    BattleResult expected = runBattle(teamA, teamB);
+
+    FighterArena arena;
+    std::size_t pooled = NamePool::size();
+    for (int reuse = 0; reuse < 3; reuse++) {
+        arena.reset(Protocol::arenaBytes(cowboys) + Protocol::arenaBytes(ninjas));
+        Team arenaA = Protocol::buildTeam(cowboys, arena);
+        Team arenaB = Protocol::buildTeam(ninjas, arena);
+        CHECK(NamePool::size() == pooled);
+        CHECK(arenaA.getLeader()->getName() == teamA.getLeader()->getName());
+        CHECK(arenaA.memoryUsage().fighters == teamA.memoryUsage().fighters);
+        BattleResult inArena = runBattle(arenaA, arenaB);
+        CHECK(inArena.winner == expected.winner);
+        CHECK(inArena.rounds == expected.rounds);
+        CHECK(inArena.hitPointsB == expected.hitPointsB);
+    }
+    FighterArena empty;
+    CHECK_THROWS_AS(Protocol::buildTeam(cowboys, empty), std::length_error);
+
+    std::string path = "/tmp/cowboy_vs_ninja_test_" + std::to_string(getpid()) + ".sock";
+    ThreadPool pool(2);
+    SimulationServer server(path, pool);
+    server.start();
+    {
+        SimulationClient client(path);
+        for (int request = 0; request < 3; request++) {
+            std::vector<BattleResult> results = client.run({full, shortBattle});
+            REQUIRE(results.size() == 2);
+            CHECK(results[0].winner == expected.winner);
+            CHECK(results[0].rounds == expected.rounds);
+            CHECK(results[0].hitPointsB == expected.hitPointsB);
+            CHECK(results[1].rounds == 2);
+        }
+        CHECK(client.run({}).empty());
+
+        SimulationClient broken(path);
+        Scenario invalid = full;
+        invalid.teamA.leader = 7;
+        CHECK_THROWS(broken.run({invalid}));
+    }
+    server.stop();
+    CHECK_THROWS(SimulationClient(path));
+    CHECK(server.requestsServed() == 4);
+    CHECK(server.latencyPercentile(0.99) >= server.latencyPercentile(0.5));
+    CHECK(server.latencyPercentile(0.99) > 0);
+}
+
+///@test MemoryBudget.hpp
+
+TEST_CASE("Test Case 27: memory accounting and the battle memory budget") {
+    Team cowboys(new Cowboy("Tom", Point(32.3, 44)));
+    cowboys.add(new YoungNinja("A young ninja with a name too long for the small string buffer", Point(64, 57)));
+    MemoryUsage usage = cowboys.memoryUsage();
+    CHECK(usage.team == sizeof(Team));
+    CHECK(usage.fighterSlots >= 2 * sizeof(Character *));
+    CHECK(usage.fighters == sizeof(Cowboy) + sizeof(YoungNinja));
+    CHECK(usage.vtablePointers == 2 * sizeof(void *));
+    CHECK(usage.of(FighterKind::Cowboy).count == 1);
+    CHECK(usage.of(FighterKind::Cowboy).bytes == sizeof(Cowboy));
+    CHECK(usage.of(FighterKind::YoungNinja).bytes == sizeof(YoungNinja));
+    CHECK(usage.of(FighterKind::OldNinja).count == 0);
+    CHECK(usage.names > 2 * sizeof(std::string) + 60);
+    CHECK(usage.total() == usage.team + usage.fighterSlots + usage.fighters);
+    CHECK(cowboys.clone().memoryUsage().fighters >= usage.fighters);
+
+    Team ninjas(new OldNinja("sushi", Point(1.3, 3.5)));
+    std::size_t bytes = battleBytes(cowboys, ninjas);
+    CHECK(bytes == usage.total() + ninjas.memoryUsage().total() + sizeof(Battle) + sizeof(DistanceMatrix));
+    BattleOptions scanned;
+    scanned.distanceMatrix = false;
+    CHECK(battleBytes(cowboys, ninjas, scanned) == bytes - sizeof(DistanceMatrix));
+
+    MemoryBudget budget(bytes);
+    BattleOptions options;
+    options.budget = &budget;
+    {
+        Battle battle(cowboys, ninjas, options);
+        CHECK(budget.inUse() == bytes);
+        CHECK_THROWS_AS(Battle(ninjas, cowboys, options), std::runtime_error);
+        CHECK(budget.refusals() == 1);
+        CHECK(budget.inUse() == bytes);
+    }
+    CHECK(budget.inUse() == 0);
+    runBattle(cowboys, ninjas, options);
+    CHECK(budget.inUse() == 0);
+
+    MemoryReservation held(budget, 1);
+    MemoryReservation moved = std::move(held);
+    CHECK(held.getBytes() == 0);
+    CHECK(budget.inUse() == 1);
+    CHECK_THROWS(MemoryReservation(budget, bytes));
+
+    // the estimate is known before the teams are built and covers them once they are
+    TeamSpec spec;
+    spec.fighters = {{FighterKind::Cowboy, 32.3, 44, 0}, {FighterKind::YoungNinja, 64, 57, 0},
+                     {FighterKind::OldNinja, 1.3, 3.5, 0}};
+    std::size_t estimate = estimatedBattleBytes(3, 3);
+    Team builtA = Protocol::buildTeam(spec);
+    Team builtB = Protocol::buildTeam(spec);
+    CHECK(estimate >= battleBytes(builtA, builtB));
+    TeamSpec large = spec;
+    large.fighters.resize(10, spec.fighters[1]);
+    Team largeA = Protocol::buildTeam(large);
+    Team largeB = Protocol::buildTeam(large);
+    CHECK(estimatedBattleBytes(10, 10) >= battleBytes(largeA, largeB));
+
+    // the server reserves the estimate before building the teams of a scenario
+    MemoryBudget serverBudget(estimate);
+    ThreadPool pool(1);
+    std::string path = "/tmp/cowboy_vs_ninja_budget_" + std::to_string(getpid()) + ".sock";
+    SimulationServer server(path, pool, &serverBudget);
+    server.start();
+    {
+        SimulationClient client(path);
+        Scenario scenario{spec, spec, BattleOptions(), Movement::FloatingPoint};
+        CHECK(client.run({scenario}).size() == 1);
+        MemoryReservation taken(serverBudget, 1);
+        CHECK_THROWS_AS(client.run({scenario}), std::runtime_error);
+        CHECK(serverBudget.refusals() == 1);
+    }
+    server.stop();
+    CHECK(serverBudget.inUse() == 0);
+}
+
+///@test Character.hpp
+
+TEST_CASE("Test Case 28: batched ninja moves match sequential moves bit for bit") {
+    std::mt19937 random(2023);
+    std::uniform_real_distribution<double> coordinate(0, 1000);
+    std::vector<std::unique_ptr<Ninja>> batched;
+    std::vector<std::unique_ptr<Ninja>> sequential;
+    for (int i = 0; i < 203; i++) {
+        Point location(coordinate(random), coordinate(random));
+        if (i % 3 == 0) {
+            batched.push_back(std::make_unique<YoungNinja>("Yogi", location));
+        } else if (i % 3 == 1) {
+            batched.push_back(std::make_unique<TrainedNinja>("Hikari", location));
+        } else {
+            batched.push_back(std::make_unique<OldNinja>("sushi", location));
+        }
+    }
+    Cowboy victim("Tom", Point(coordinate(random), coordinate(random)));
+    // Close enough to arrive in one step, and one dead ninja that must not move.
+    batched[7]->setLocation(Point(victim.getLocation().getX() + 0.3, victim.getLocation().getY() + 5));
+    batched[11]->hit(1000);
+    for (const auto &ninja: batched) {
+        if (dynamic_cast<YoungNinja *>(ninja.get())) {
+            sequential.push_back(std::make_unique<YoungNinja>(*dynamic_cast<YoungNinja *>(ninja.get())));
+        } else if (dynamic_cast<TrainedNinja *>(ninja.get())) {
+            sequential.push_back(std::make_unique<TrainedNinja>(*dynamic_cast<TrainedNinja *>(ninja.get())));
+        } else {
+            sequential.push_back(std::make_unique<OldNinja>(*dynamic_cast<OldNinja *>(ninja.get())));
+        }
+    }
+
+    std::vector<Ninja *> batch;
+    for (const auto &ninja: batched) {
+        batch.push_back(ninja.get());
+    }
+    for (int step = 0; step < 5; step++) {
+        Ninja::moveAll(batch, &victim);
+        for (const auto &ninja: sequential) {
+            if (ninja->getLocation().distance(victim.getLocation()) > 0) {
+                ninja->move(&victim);
+            }
+        }
+        // Ninjas that arrived stand on the victim now, they leave the batch like they stop moving above.
+        std::erase_if(batch, [&victim](Ninja *ninja) {
+            return ninja->getLocation().distance(victim.getLocation()) == 0;
+        });
+    }
+    for (std::size_t i = 0; i < batched.size(); i++) {
+        CHECK(batched[i]->getLocation().getX() == sequential[i]->getLocation().getX());
+        CHECK(batched[i]->getLocation().getY() == sequential[i]->getLocation().getY());
+    }
+    CHECK(batched[7]->getLocation().distance(victim.getLocation()) == 0);
+    CHECK(batched[11]->getLocation().getX() == sequential[11]->getLocation().getX());
+
+    Ninja *onVictim[] = {batched[0].get(), batched[7].get(), batched[1].get()};
+    Point before = batched[1]->getLocation();
+    CHECK_THROWS_AS(Ninja::moveAll(onVictim, &victim), std::invalid_argument);
+    CHECK(batched[1]->getLocation().getX() == before.getX());
+    CHECK_THROWS(Ninja::moveAll(onVictim, nullptr));
+}
+
+///@test TeamIndex.hpp
+
+TEST_CASE("Test Case 29: the k-d tree index finds the same fighters as the linear scan") {
+    Team small(new Cowboy("Tom", Point(0, 0)), 2);
+    CHECK(small.getCapacity() == 2);
+    small.add(new OldNinja("sushi", Point(1, 1)));
+    Cowboy *extra = new Cowboy("Extra", Point(2, 2));
+    CHECK_THROWS_AS(small.add(extra), std::invalid_argument);
+    delete extra;
+    CHECK_THROWS(Team(new Cowboy("Zero", Point(0, 0)), 0));
+    CHECK(Team(new Cowboy("Default", Point(0, 0))).getCapacity() == Team::DEFAULT_CAPACITY);
+
+    std::mt19937 random(2023);
+    std::uniform_int_distribution<int> coordinate(0, 300);
+    auto randomPoint = [&] { return Point(coordinate(random), coordinate(random)); };
+    auto makeRoster = [&](std::mt19937 &rng, int size) {
+        std::uniform_int_distribution<int> grid(0, 300);
+        Team team(new Cowboy("Leader", Point(grid(rng), grid(rng))), static_cast<std::size_t>(size));
+        for (int i = 1; i < size; i++) {
+            // Integer coordinates, so many fighters are at exactly the same distance.
+            Point location(grid(rng), grid(rng));
+            if (i % 4 == 0) {
+                team.add(new YoungNinja("Yogi", location));
+            } else {
+                team.add(new Cowboy("Tom", location));
+            }
+        }
+        return team;
+    };
+    std::mt19937 rosterSeed(7);
+    Team roster = makeRoster(rosterSeed, 3000);
+    roster.setIndexing(Indexing::Spatial);
+    CHECK(roster.getIndexing() == Indexing::Spatial);
+    Team reference = roster.clone();
+    reference.setIndexing(Indexing::LinearScan);
+    CHECK(roster.clone().getIndexing() == Indexing::Spatial);
+
+    auto compare = [&] {
+        for (int query = 0; query < 200; query++) {
+            Point origin = randomPoint();
+            Character *indexed = roster.findClosestCharacter(origin, roster.getFighters());
+            Character *scanned = reference.findClosestCharacter(origin, reference.getFighters());
+            auto position = [](const Team &team, const Character *fighter) {
+                const auto &fighters = team.getFighters();
+                return std::find(fighters.begin(), fighters.end(), fighter) - fighters.begin();
+            };
+            REQUIRE(position(roster, indexed) == position(reference, scanned));
+        }
+    };
+    compare();
 
+    // Kill a third of the fighters, move some cowboys and ninjas, in both teams the same way.
+    for (std::size_t i = 0; i < roster.getFighters().size(); i += 3) {
+        roster.getFighters()[i]->hit(200);
+        reference.getFighters()[i]->hit(200);
+    }
+    for (std::size_t i = 1; i < roster.getFighters().size(); i += 50) {
+        Point location = randomPoint();
+        roster.getFighters()[i]->setLocation(location);
+        reference.getFighters()[i]->setLocation(location);
+    }
+    compare();
+    CHECK(roster.memoryUsage().index > 0);
+    CHECK(reference.memoryUsage().index == 0);
+
+    std::mt19937 seedA(11);
+    std::mt19937 seedB(12);
+    Team indexedA = makeRoster(seedA, 300);
+    Team indexedB = makeRoster(seedB, 300);
+    Team linearA = indexedA.clone();
+    Team linearB = indexedB.clone();
+    indexedA.setIndexing(Indexing::Spatial);
+    indexedB.setIndexing(Indexing::Spatial);
+    BattleOptions options;
+    options.maxRounds = 20;
+    BattleResult indexed = runBattle(indexedA, indexedB, options);
+    BattleResult linear = runBattle(linearA, linearB, options);
+    CHECK(indexed.damageDealtA == linear.damageDealtA);
+    CHECK(indexed.damageDealtB == linear.damageDealtB);
+    CHECK(indexed.hitPointsA == linear.hitPointsA);
+    CHECK(indexed.hitPointsB == linear.hitPointsB);
+}
+
+///@test LooseQuadtree.hpp
+TEST_CASE("Test Case 30: the loose quadtree follows moving, dying and revived ninjas") {
+    std::mt19937 random(2023);
+    std::uniform_real_distribution<double> coordinate(0, 500);
+    auto randomPoint = [&] { return Point(coordinate(random), coordinate(random)); };
+    Team roster(new Cowboy("Leader", randomPoint()), 2000);
+    for (int i = 1; i < 2000; i++) {
+        if (i % 10 == 0) {
+            roster.add(new Cowboy("Tom", randomPoint()));
+        } else {
+            roster.add(new TrainedNinja("Hiro", randomPoint()));
+        }
+    }
+    roster.setIndexing(Indexing::Spatial);
+    Team reference = roster.clone();
+    reference.setIndexing(Indexing::LinearScan);
+    const auto &fighters = roster.getFighters();
+    const auto &referenceFighters = reference.getFighters();
+
+    auto compare = [&] {
+        for (int query = 0; query < 200; query++) {
+            Point origin = randomPoint();
+            Character *indexed = roster.findClosestCharacter(origin, fighters);
+            Character *scanned = reference.findClosestCharacter(origin, referenceFighters);
+            REQUIRE(std::find(fighters.begin(), fighters.end(), indexed) - fighters.begin() ==
+                    std::find(referenceFighters.begin(), referenceFighters.end(), scanned) -
+                    referenceFighters.begin());
+        }
+    };
+    compare();
+
+    // Small steps stay in the loose leaves, jumps across the field move ninjas between leaves and out of the tree.
+    for (int round = 0; round < 10; round++) {
+        for (std::size_t i = 1; i < fighters.size(); i++) {
+            if (fighters[i]->kind() == FighterKind::Cowboy) {
+                continue;
+            }
+            Point step = round % 3 == 2 ? randomPoint()
+                                        : Point(fighters[i]->getLocation().getX() + coordinate(random) / 100,
+                                                fighters[i]->getLocation().getY() + coordinate(random) / 100);
+            fighters[i]->setLocation(step);
+            referenceFighters[i]->setLocation(step);
+        }
+        for (std::size_t i = static_cast<std::size_t>(round); i < fighters.size(); i += 7) {
+            fighters[i]->hit(40);
+            referenceFighters[i]->hit(40);
+        }
+        compare();
+    }
+    for (std::size_t i = 0; i < fighters.size(); i += 5) {
+        fighters[i]->setHitPoints(100);
+        referenceFighters[i]->setHitPoints(100);
+    }
+    compare();
+    Point far(10000, 10000);
+    for (std::size_t i = 1; i < 40; i++) {
+        fighters[i]->setLocation(far);
+        referenceFighters[i]->setLocation(far);
+    }
+    compare();
+
+    LooseQuadtree tree;
+    std::vector<IndexedFighter> entries;
+    Ninja *first = new YoungNinja("Yogi", Point(10, 10));
+    Ninja *second = new OldNinja("sushi", Point(20, 20));
+    entries.push_back({first->getLocation(), first, 0});
+    entries.push_back({second->getLocation(), second, 1});
+    tree.build(entries);
+    CHECK(tree.size() == 2);
+    first->setLocation(Point(5000, 5000));
+    tree.moved(first);
+    CHECK(tree.outsideCount() == 1);
+    NearestCandidate best;
+    tree.collect(Point(4000, 4000), best);
+    CHECK(best.fighter == first);
+    second->hit(200);
+    tree.aliveChanged(second);
+    CHECK(tree.size() == 1);
+    delete first;
+    delete second;
+
+    std::mt19937 seedA(21);
+    std::mt19937 seedB(22);
+    auto makeNinjas = [](std::mt19937 &rng) {
+        std::uniform_int_distribution<int> grid(0, 300);
+        Team team(new Cowboy("Leader", Point(grid(rng), grid(rng))), 300);
+        for (int i = 1; i < 300; i++) {
+            Point location(grid(rng), grid(rng));
+            if (i % 3 == 0) {
+                team.add(new YoungNinja("Yogi", location));
+            } else {
+                team.add(new OldNinja("sushi", location));
+            }
+        }
+        return team;
+    };
+    Team indexedA = makeNinjas(seedA);
+    Team indexedB = makeNinjas(seedB);
+    Team linearA = indexedA.clone();
+    Team linearB = indexedB.clone();
+    indexedA.setIndexing(Indexing::Spatial);
+    indexedB.setIndexing(Indexing::Spatial);
+    BattleOptions options;
+    options.maxRounds = 20;
+    BattleResult indexed = runBattle(indexedA, indexedB, options);
+    BattleResult linear = runBattle(linearA, linearB, options);
+    CHECK(indexed.damageDealtA == linear.damageDealtA);
+    CHECK(indexed.damageDealtB == linear.damageDealtB);
+    CHECK(indexed.hitPointsA == linear.hitPointsA);
+    CHECK(indexed.hitPointsB == linear.hitPointsB);
+}
 
+///@test Team.hpp
+TEST_CASE("Test Case 31: radius and k nearest queries match a sorted copy of the fighters") {
+    std::mt19937 random(2023);
+    std::uniform_int_distribution<int> coordinate(0, 400);
+    auto randomPoint = [&] { return Point(coordinate(random), coordinate(random)); };
+    Team indexed(new Cowboy("Leader", randomPoint()), 2000);
+    for (int i = 1; i < 2000; i++) {
+        if (i % 3 == 0) {
+            indexed.add(new Cowboy("Tom", randomPoint()));
+        } else {
+            indexed.add(new YoungNinja("Yogi", randomPoint()));
+        }
+    }
+    indexed.setIndexing(Indexing::Spatial);
+    Team linear = indexed.clone();
+    linear.setIndexing(Indexing::LinearScan);
+
+    // Reference answers: positions of the living fighters sorted by distance, then by position.
+    auto sortedPositions = [](const Team &team, const Point &origin) {
+        std::vector<std::pair<double, std::size_t>> sorted;
+        for (std::size_t i = 0; i < team.getFighters().size(); i++) {
+            if (team.getFighters()[i]->isAlive()) {
+                sorted.emplace_back(origin.distance(team.getFighters()[i]->getLocation()), i);
+            }
+        }
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    };
+    auto position = [](const Team &team, const Character *fighter) {
+        const auto &fighters = team.getFighters();
+        return static_cast<std::size_t>(std::find(fighters.begin(), fighters.end(), fighter) - fighters.begin());
+    };
+    auto compare = [&] {
+        for (int query = 0; query < 50; query++) {
+            Point origin = randomPoint();
+            auto sorted = sortedPositions(linear, origin);
+            for (const Team *team: {&indexed, &linear}) {
+                for (std::size_t k: {std::size_t{1}, std::size_t{7}, std::size_t{64}}) {
+                    std::vector<NearestHit> hits(k);
+                    std::size_t found = team->kNearest(origin, hits);
+                    REQUIRE(found == std::min(k, sorted.size()));
+                    for (std::size_t i = 0; i < found; i++) {
+                        REQUIRE(position(*team, hits[i].fighter) == sorted[i].second);
+                        REQUIRE(hits[i].distance == sorted[i].first);
+                    }
+                }
+                double radius = coordinate(random) / 4.0;
+                std::vector<std::size_t> visited;
+                team->withinRadius(origin, radius, [&](Character *fighter, double distance) {
+                    CHECK(distance <= radius);
+                    visited.push_back(position(*team, fighter));
+                });
+                std::sort(visited.begin(), visited.end());
+                std::vector<std::size_t> expected;
+                for (const auto &entry: sorted) {
+                    if (entry.first <= radius) {
+                        expected.push_back(entry.second);
+                    }
+                }
+                std::sort(expected.begin(), expected.end());
+                REQUIRE(visited == expected);
+            }
+        }
+    };
+    compare();
+    for (std::size_t i = 0; i < indexed.getFighters().size(); i += 4) {
+        indexed.getFighters()[i]->hit(200);
+        linear.getFighters()[i]->hit(200);
+    }
+    for (std::size_t i = 1; i < indexed.getFighters().size(); i += 9) {
+        Point location = randomPoint();
+        indexed.getFighters()[i]->setLocation(location);
+        linear.getFighters()[i]->setLocation(location);
+    }
+    compare();
+
+    std::vector<NearestHit> none;
+    CHECK(indexed.kNearest(Point(0, 0), none) == 0);
+    std::vector<NearestHit> all(3000);
+    CHECK(indexed.kNearest(Point(0, 0), all) == static_cast<std::size_t>(indexed.stillAlive()));
+    CHECK(all[0].fighter == indexed.findClosestCharacter(Point(0, 0), indexed.getFighters()));
+    CHECK_THROWS_AS(indexed.withinRadius(Point(0, 0), -1, [](Character *, double) {}), std::invalid_argument);
+}
 
+///@test ProximityCache.hpp
+TEST_CASE("Test Case 32: sharing nearest answers between attacks does not change any battle") {
+    std::mt19937 random(2023);
+    std::size_t hits = 0;
+    for (int battle = 0; battle < 60; battle++) {
+        std::uint32_t seed = random();
+        bool cowboysOnly = battle % 3 == 0;
+        std::mt19937 rng(seed);
+        Team sharedA = randomTeam(rng, 10, cowboysOnly);
+        Team sharedB = randomTeam(rng, 10, cowboysOnly);
+        Team aloneA = sharedA.clone();
+        Team aloneB = sharedB.clone();
+        if (battle % 2 == 1) {
+            for (Team *team: {&sharedA, &sharedB, &aloneA, &aloneB}) {
+                team->setMovement(Movement::Deterministic);
+            }
+        }
+        BattleOptions options;
+        Battle shared(sharedA, sharedB, options);
+        while (!shared.finished()) {
+            shared.playRound();
+        }
+        options.shareProximity = false;
+        Battle alone(aloneA, aloneB, options);
+        while (!alone.finished()) {
+            alone.playRound();
+        }
+        CHECK(alone.getProximity().hits() + alone.getProximity().misses() == 0);
+        hits += shared.getProximity().hits();
+        BattleResult first = shared.result();
+        BattleResult second = alone.result();
+        CHECK(first.winner == second.winner);
+        CHECK(first.rounds == second.rounds);
+        CHECK(first.damageDealtA == second.damageDealtA);
+        CHECK(first.damageDealtB == second.damageDealtB);
+        for (std::size_t i = 0; i < sharedA.getFighters().size(); i++) {
+            CHECK(sharedA.getFighters()[i]->getHitPoints() == aloneA.getFighters()[i]->getHitPoints());
+            CHECK(sharedA.getFighters()[i]->getLocation().getX() == aloneA.getFighters()[i]->getLocation().getX());
+            CHECK(sharedB.getFighters()[i]->getHitPoints() == aloneB.getFighters()[i]->getHitPoints());
+            CHECK(sharedB.getFighters()[i]->getLocation().getY() == aloneB.getFighters()[i]->getLocation().getY());
+        }
+    }
+    CHECK(hits > 0);
+
+    Team first(new Cowboy("A", Point(0, 0)));
+    Team second(new Cowboy("B", Point(1, 1)));
+    Team third(new Cowboy("C", Point(2, 2)));
+    ProximityCache cache;
+    Character *answer = nullptr;
+    CHECK_FALSE(cache.find(&first, Point(0, 0), Movement::FloatingPoint, Ranking::Exact, answer));
+    cache.store(&first, Point(0, 0), Movement::FloatingPoint, Ranking::Exact, first.getLeader());
+    CHECK(cache.find(&first, Point(0, 0), Movement::FloatingPoint, Ranking::Exact, answer));
+    CHECK(answer == first.getLeader());
+    CHECK_FALSE(cache.find(&first, Point(0, 0), Movement::Deterministic, Ranking::Exact, answer));
+    cache.changed(&first);
+    CHECK_FALSE(cache.find(&first, Point(0, 0), Movement::FloatingPoint, Ranking::Exact, answer));
+    cache.changed(&second);
+    CHECK_THROWS_AS(cache.changed(&third), std::invalid_argument);
+}
 
+///@test Team.hpp
+TEST_CASE("Test Case 33: the Morton layout keeps the turn order and every answer") {
+    std::mt19937 random(2023);
+    std::uniform_int_distribution<int> coordinate(0, 200);
+    Team laidOut = randomTeam(random, 500, false, 200);
+    Team reference = laidOut.clone();
+    laidOut.setLayout(Layout::Morton);
+    CHECK(laidOut.getLayout() == Layout::Morton);
+    CHECK(reference.getLayout() == Layout::Insertion);
+    const auto &fighters = laidOut.getFighters();
+    const auto &referenceFighters = reference.getFighters();
+    REQUIRE(fighters.size() == referenceFighters.size());
+    for (std::size_t i = 0; i < fighters.size(); i++) {
+        CHECK(fighters[i]->kind() == referenceFighters[i]->kind());
+        CHECK(fighters[i]->getName() == referenceFighters[i]->getName());
+        CHECK(fighters[i]->getLocation().getX() == referenceFighters[i]->getLocation().getX());
+        CHECK(fighters[i]->getLocation().getY() == referenceFighters[i]->getLocation().getY());
+    }
+    CHECK(laidOut.getLeader() == fighters[0]);
+
+    // Walking the fighters by address visits the board in small steps, unlike walking them by turn.
+    std::vector<const Character *> byAddress(fighters.begin(), fighters.end());
+    std::sort(byAddress.begin(), byAddress.end(), std::less<>());
+    double memoryWalk = 0;
+    double turnWalk = 0;
+    for (std::size_t i = 1; i < fighters.size(); i++) {
+        memoryWalk += byAddress[i]->distance(byAddress[i - 1]);
+        turnWalk += fighters[i]->distance(fighters[i - 1]);
+    }
+    CHECK(memoryWalk * 4 < turnWalk);
+
+    auto compare = [&] {
+        CHECK(laidOut.stillAlive() == reference.stillAlive());
+        for (int query = 0; query < 100; query++) {
+            Point origin(coordinate(random), coordinate(random));
+            Character *found = laidOut.findClosestCharacter(origin, fighters);
+            Character *expected = reference.findClosestCharacter(origin, referenceFighters);
+            REQUIRE(std::find(fighters.begin(), fighters.end(), found) - fighters.begin() ==
+                    std::find(referenceFighters.begin(), referenceFighters.end(), expected) -
+                    referenceFighters.begin());
+            std::array<NearestHit, 5> hits{};
+            std::array<NearestHit, 5> expectedHits{};
+            REQUIRE(laidOut.kNearest(origin, hits) == reference.kNearest(origin, expectedHits));
+            for (std::size_t i = 0; i < hits.size(); i++) {
+                CHECK(hits[i].order == expectedHits[i].order);
+            }
+        }
+    };
+    compare();
+    for (std::size_t i = 0; i < fighters.size(); i += 3) {
+        fighters[i]->hit(200);
+        referenceFighters[i]->hit(200);
+    }
+    laidOut.relayout();
+    compare();
+    laidOut.setLayout(Layout::Insertion);
+    compare();
+
+    for (int battle = 0; battle < 20; battle++) {
+        std::uint32_t seed = random();
+        std::mt19937 rng(seed);
+        std::size_t size = battle % 4 == 0 ? 120 : 10;
+        Team mortonA = randomTeam(rng, size, false, 200);
+        Team mortonB = randomTeam(rng, size, false, 200);
+        Team plainA = mortonA.clone();
+        Team plainB = mortonB.clone();
+        mortonA.setLayout(Layout::Morton);
+        mortonB.setLayout(Layout::Morton);
+        BattleOptions options;
+        options.maxRounds = 50;
+        BattleResult plain = runBattle(plainA, plainB, options);
+        options.relayoutEvery = 1 + battle % 3;
+        BattleResult morton = runBattle(mortonA, mortonB, options);
+        CHECK(plain.winner == morton.winner);
+        CHECK(plain.rounds == morton.rounds);
+        CHECK(plain.damageDealtA == morton.damageDealtA);
+        CHECK(plain.damageDealtB == morton.damageDealtB);
+        CHECK(plain.hitPointsA == morton.hitPointsA);
+        CHECK(plain.hitPointsB == morton.hitPointsB);
+    }
+    BattleOptions negative;
+    negative.relayoutEvery = -1;
+    CHECK_THROWS_AS(runBattle(laidOut, reference, negative), std::invalid_argument);
+}
 
+///@test Point.hpp
+TEST_CASE("Test Case 34: approximate ranking stays within its documented error") {
+    std::mt19937 random(2023);
+    std::uniform_real_distribution<double> coordinate(0, 1000);
+    for (int i = 0; i < 100000; i++) {
+        Point first(coordinate(random), coordinate(random));
+        Point second(coordinate(random), coordinate(random));
+        double exact = first.distance(second);
+        double approximate = first.approximateDistance(second);
+        REQUIRE(std::abs(approximate - exact) <= Point::APPROXIMATE_DISTANCE_ERROR * exact);
+        PointF firstF(first);
+        PointF secondF(second);
+        REQUIRE(std::abs(firstF.approximateDistance(secondF) - firstF.distance(secondF)) <=
+                static_cast<float>(Point::APPROXIMATE_DISTANCE_ERROR) * firstF.distance(secondF) + 1e-3f);
+    }
+    CHECK(Point(3, 4).approximateDistance(Point(3, 4)) == 0);
+
+    // Approximate picks are never much farther than the exact ones, and audited teams count the differences.
+    const double worstRatio = (1 + Point::APPROXIMATE_DISTANCE_ERROR) / (1 - Point::APPROXIMATE_DISTANCE_ERROR);
+    Team attackers(new Cowboy("Leader", Point(500, 500)), 1);
+    Team defenders(new Cowboy("Leader", Point(coordinate(random), coordinate(random))), 2000);
+    for (int i = 1; i < 2000; i++) {
+        defenders.add(new OldNinja("sushi", Point(coordinate(random), coordinate(random))));
+    }
+    Team exactAttackers = attackers.clone();
+    attackers.setRanking(Ranking::Audited);
+    CHECK(attackers.getRanking() == Ranking::Audited);
+    CHECK(attackers.clone().getRanking() == Ranking::Audited);
+    std::size_t differences = 0;
+    for (std::size_t i = 0; i < 200; i++) {
+        // Each attack hits the nearest defender by the ranking, compare who was hit.
+        std::vector<int> before;
+        for (const Character *fighter: defenders.getFighters()) {
+            before.push_back(fighter->getHitPoints());
+        }
+        Point origin(coordinate(random), coordinate(random));
+        attackers.getLeader()->setLocation(origin);
+        exactAttackers.getLeader()->setLocation(origin);
+        Character *exact = defenders.findClosestCharacter(origin, defenders.getFighters());
+        attackers.attack(&defenders);
+        Character *hit = nullptr;
+        for (std::size_t j = 0; j < before.size(); j++) {
+            if (defenders.getFighters()[j]->getHitPoints() != before[j]) {
+                hit = defenders.getFighters()[j];
+            }
+        }
+        REQUIRE(hit != nullptr);
+        CHECK(origin.distance(hit->getLocation()) <= origin.distance(exact->getLocation()) * worstRatio);
+        if (hit != exact) {
+            differences++;
+        }
+        hit->setHitPoints(150);
+        if (!attackers.getLeader()->isAlive()) {
+            break;
+        }
+        static_cast<Cowboy *>(attackers.getLeader())->reload();
+    }
+    RankingStats stats = attackers.getRankingStats();
+    CHECK(stats.queries >= 200);
+    CHECK(stats.mismatches >= differences);
+    CHECK(stats.mismatches < stats.queries / 2);
+    CHECK(exactAttackers.getRankingStats().queries == 0);
+
+    // Spatially indexed enemies are searched exactly, there is nothing to audit.
+    defenders.setIndexing(Indexing::Spatial);
+    attackers.attack(&defenders);
+    CHECK(attackers.getRankingStats().queries == stats.queries);
+
+    ProximityCache cache;
+    Character *answer = nullptr;
+    cache.store(&defenders, Point(1, 1), Movement::FloatingPoint, Ranking::Approximate, defenders.getLeader());
+    CHECK_FALSE(cache.find(&defenders, Point(1, 1), Movement::FloatingPoint, Ranking::Exact, answer));
+    CHECK(cache.find(&defenders, Point(1, 1), Movement::FloatingPoint, Ranking::Approximate, answer));
+}
 
+///@test DistanceMatrix.hpp
+TEST_CASE("Test Case 35: the distance matrix of a small battle gives the answers of a scan") {
+    std::mt19937 random(2023);
+    std::size_t answers = 0;
+    for (int battle = 0; battle < 60; battle++) {
+        std::uint32_t seed = random();
+        std::mt19937 rng(seed);
+        Team matrixA = randomTeam(rng, 10);
+        Team matrixB = randomTeam(rng, 10);
+        if (battle % 3 == 1) {
+            matrixB.setMovement(Movement::Deterministic);
+        }
+        if (battle % 3 == 2) {
+            matrixA.setLayout(Layout::Morton);
+        }
+        Team scanA = matrixA.clone();
+        Team scanB = matrixB.clone();
+        BattleOptions options;
+        options.relayoutEvery = 2;
+        Battle withMatrix(matrixA, matrixB, options);
+        while (!withMatrix.finished()) {
+            withMatrix.playRound();
+        }
+        options.distanceMatrix = false;
+        Battle withoutMatrix(scanA, scanB, options);
+        while (!withoutMatrix.finished()) {
+            withoutMatrix.playRound();
+        }
+        CHECK(withoutMatrix.getProximity().distances() == nullptr);
+        REQUIRE(withMatrix.getProximity().distances() != nullptr);
+        answers += withMatrix.getProximity().distances()->answers();
+        BattleResult first = withMatrix.result();
+        BattleResult second = withoutMatrix.result();
+        CHECK(first.winner == second.winner);
+        CHECK(first.rounds == second.rounds);
+        CHECK(first.damageDealtA == second.damageDealtA);
+        CHECK(first.damageDealtB == second.damageDealtB);
+        for (std::size_t i = 0; i < matrixA.getFighters().size(); i++) {
+            CHECK(matrixA.getFighters()[i]->getHitPoints() == scanA.getFighters()[i]->getHitPoints());
+            CHECK(matrixA.getFighters()[i]->getLocation().getX() == scanA.getFighters()[i]->getLocation().getX());
+            CHECK(matrixB.getFighters()[i]->getHitPoints() == scanB.getFighters()[i]->getHitPoints());
+            CHECK(matrixB.getFighters()[i]->getLocation().getY() == scanB.getFighters()[i]->getLocation().getY());
+        }
+    }
+    CHECK(answers > 0);
+
+    std::mt19937 rng(7);
+    Team first = randomTeam(rng, 10);
+    Team second = randomTeam(rng, 10);
+    DistanceMatrix matrix;
+    CHECK_FALSE(matrix.attached());
+    CHECK(matrix.attach(first, second));
+    CHECK(matrix.attached());
+    for (int step = 0; step < 20; step++) {
+        for (Character *fighter: first.getFighters()) {
+            Ninja *ninja = dynamic_cast<Ninja *>(fighter);
+            if (ninja != nullptr && ninja->getLocation().distance(second.getLeader()->getLocation()) > 0) {
+                ninja->move(second.getLeader());
+                matrix.moved(ninja);
+            }
+        }
+        for (const Team *team: {&first, &second}) {
+            for (const Character *from: team->getFighters()) {
+                for (const Team *owner: {&first, &second}) {
+                    Character *answer = nullptr;
+                    CHECK(matrix.nearest(from->getLocation(), *owner, answer));
+                    CHECK(answer == first.pickTarget(from->getLocation(), *owner));
+                }
+            }
+        }
+        second.getFighters()[static_cast<std::size_t>(step) % 10]->hit(40);
+    }
+    Character *answer = nullptr;
+    CHECK_FALSE(matrix.nearest(Point(-1000, -1000), first, answer));
+    Team third = randomTeam(rng, 1);
+    CHECK_FALSE(matrix.nearest(third.getLeader()->getLocation(), third, answer));
+    Team large(new Cowboy("Leader", Point(0, 0)), 11);
+    for (int i = 1; i < 11; i++) {
+        large.add(new Cowboy("Tom", Point(i, i)));
+    }
+    CHECK_FALSE(matrix.attach(first, large));
+    CHECK_FALSE(matrix.attached());
+    // a battle only holds a matrix it can use
+    Battle oversized(first, large);
+    CHECK(oversized.getProximity().distances() == nullptr);
+    CHECK(sizeof(Battle) < sizeof(DistanceMatrix));
+}
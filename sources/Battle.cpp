@@ -0,0 +1,204 @@
+/**
+ * @file Battle.cpp
+ * @brief Runs a full battle between two teams without printing anything.
+ * A round is teamA attacking teamB followed by teamB attacking teamA (if teamB is still standing).
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "Battle.hpp"
+
+namespace ariel {
+
+    namespace {
+
+        /**
+         * @brief Liveness state of one team.
+         */
+        struct TeamState {
+            int alive = 0;
+            int hitPoints = 0;
+        };
+
+        /**
+         * @brief Scans the team once and collects both the alive count and the total hit points.
+         * @param team The team to scan.
+         * @return The current state of the team.
+         */
+        TeamState scan(const Team &team) {
+            TeamState state;
+            for (const Character *fighter: team.getFighters()) {
+                if (fighter->isAlive()) {
+                    state.alive++;
+                    state.hitPoints += fighter->getHitPoints();
+                }
+            }
+            return state;
+        }
+    }
+
+/**
+ * @brief Prepares a battle between two teams, no round is played yet.
+ * @param teamA The team that attacks first in every round.
+ * @param teamB The team that attacks second in every round.
+ * @param options Battle options such as the maximum number of rounds.
+ * @throws std::invalid_argument If both arguments refer to the same team, the round limit or the relayout
+ * interval is negative.
+ * @throws std::runtime_error If the battle does not fit in the memory budget of the options.
+ */
+    Battle::Battle(Team &teamA, Team &teamB, const BattleOptions &options) :
+            teamA(&teamA), teamB(&teamB), options(options) {
+        if (&teamA == &teamB) {
+            throw std::invalid_argument("Error: A team cannot battle herself.");
+        }
+        if (options.maxRounds < 0) {
+            throw std::invalid_argument("Error: Max rounds cannot be negative.");
+        }
+        if (options.relayoutEvery < 0) {
+            throw std::invalid_argument("Error: Relayout interval cannot be negative.");
+        }
+        if (options.budget != nullptr) {
+            reservation = MemoryReservation(*options.budget, battleBytes(teamA, teamB, options));
+        }
+        if (options.shareProximity && options.distanceMatrix) {
+            proximity.attach(teamA, teamB);
+        }
+        TeamState stateA = scan(teamA);
+        TeamState stateB = scan(teamB);
+        current.survivorsA = stateA.alive;
+        current.hitPointsA = stateA.hitPoints;
+        current.survivorsB = stateB.alive;
+        current.hitPointsB = stateB.hitPoints;
+    }
+
+/**
+ * @brief Checks whether the battle is over.
+ * @return true if a team was eliminated or the round limit was reached.
+ */
+    bool Battle::finished() const {
+        if (current.survivorsA == 0 || current.survivorsB == 0) {
+            return true;
+        }
+        return options.maxRounds > 0 && current.rounds >= options.maxRounds;
+    }
+
+/**
+ * @brief Plays one round: teamA attacks, then teamB attacks if it is still standing.
+ * Only the defending team can lose hit points during an attack, so after every attack only the defender is rescanned.
+ * Teams laid out in Morton order are laid out again every options.relayoutEvery rounds.
+ * @throws std::runtime_error If the battle is already finished.
+ */
+    void Battle::playRound() {
+        if (finished()) {
+            throw std::runtime_error("Error: The battle is already finished.");
+        }
+        current.rounds++;
+
+        ProximityCache *shared = options.shareProximity ? &proximity : nullptr;
+        teamA->attack(teamB, shared);
+        TeamState afterB = scan(*teamB);
+        current.damageDealtA += current.hitPointsB - afterB.hitPoints;
+        current.survivorsB = afterB.alive;
+        current.hitPointsB = afterB.hitPoints;
+        if (afterB.alive == 0) {
+            return;
+        }
+
+        teamB->attack(teamA, shared);
+        TeamState afterA = scan(*teamA);
+        current.damageDealtB += current.hitPointsA - afterA.hitPoints;
+        current.survivorsA = afterA.alive;
+        current.hitPointsA = afterA.hitPoints;
+
+        if (options.relayoutEvery > 0 && current.rounds % options.relayoutEvery == 0) {
+            bool relaidOut = false;
+            for (Team *team: {teamA, teamB}) {
+                if (team->getLayout() == Layout::Morton) {
+                    team->relayout(team == teamA ? teamB : teamA);
+                    // The cached answers point to the fighters before they moved in memory.
+                    proximity.changed(team);
+                    relaidOut = true;
+                }
+            }
+            if (relaidOut && options.shareProximity && options.distanceMatrix) {
+                proximity.attach(*teamA, *teamB);
+            }
+        }
+    }
+
+/**
+ * @brief The outcome so far, the winner is set once a team was eliminated.
+ */
+    BattleResult Battle::result() const {
+        BattleResult result = current;
+        if (result.survivorsA > 0 && result.survivorsB == 0) {
+            result.winner = BattleWinner::TeamA;
+        } else if (result.survivorsB > 0 && result.survivorsA == 0) {
+            result.winner = BattleWinner::TeamB;
+        }
+        return result;
+    }
+
+/**
+ * @brief Getter for the team attacking first.
+ */
+    Team &Battle::getTeamA() const {
+        return *teamA;
+    }
+
+/**
+ * @brief Getter for the team attacking second.
+ */
+    Team &Battle::getTeamB() const {
+        return *teamB;
+    }
+
+/**
+ * @brief The nearest query answers shared by the attacks, with how often they were used.
+ */
+    const ProximityCache &Battle::getProximity() const {
+        return proximity;
+    }
+
+/**
+ * @brief Bytes a battle between two teams holds: both teams (names excluded), the battle state and the distance
+ * matrix when the options give the battle one.
+ */
+    std::size_t battleBytes(const Team &teamA, const Team &teamB, const BattleOptions &options) {
+        std::size_t bytes = teamA.memoryUsage().total() + teamB.memoryUsage().total() + sizeof(Battle);
+        if (options.shareProximity && options.distanceMatrix && DistanceMatrix::fits(teamA, teamB)) {
+            bytes += sizeof(DistanceMatrix);
+        }
+        return bytes;
+    }
+
+/**
+ * @brief Bytes a battle between teams of that many fighters holds at most, to reserve before building the teams.
+ * An upper bound of battleBytes() for teams built by Protocol.
+ */
+    std::size_t estimatedBattleBytes(std::size_t fightersA, std::size_t fightersB, const BattleOptions &options) {
+        std::size_t bytes = Team::estimatedBytes(fightersA) + Team::estimatedBytes(fightersB) + sizeof(Battle);
+        if (options.shareProximity && options.distanceMatrix && fightersA + fightersB <= DistanceMatrix::MAX_FIGHTERS) {
+            bytes += sizeof(DistanceMatrix);
+        }
+        return bytes;
+    }
+
+/**
+ * @brief Fights teamA against teamB until one of them is eliminated or the round limit is reached.
+ * @param teamA The team that attacks first in every round.
+ * @param teamB The team that attacks second in every round.
+ * @param options Battle options such as the maximum number of rounds.
+ * @return The winner, the number of rounds played, the survivors and the damage dealt by each team.
+ * @throws std::invalid_argument If both arguments refer to the same team or the round limit is negative.
+ * @throws std::runtime_error If the battle does not fit in the memory budget of the options.
+ */
+    BattleResult runBattle(Team &teamA, Team &teamB, const BattleOptions &options) {
+        Battle battle(teamA, teamB, options);
+        while (!battle.finished()) {
+            battle.playRound();
+        }
+        return battle.result();
+    }
+
+}
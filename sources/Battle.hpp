@@ -0,0 +1,86 @@
+/**
+ * @file Battle.hpp
+ * @brief Declares runBattle - a single call that fights two teams to the end and reports the outcome.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_BATTLE_HPP
+#define COWBOY_VS_NINJA_A_BATTLE_HPP
+
+#include "Team.hpp"
+#include "MemoryBudget.hpp"
+#include "ProximityCache.hpp"
+
+namespace ariel {
+
+    enum class BattleWinner {
+        TeamA,
+        TeamB,
+        None
+    };
+
+    struct BattleOptions {
+        // Maximum number of rounds to play, 0 means no limit.
+        int maxRounds = 0;
+        // Budget the battle reserves battleBytes() from while it exists, nullptr means no limit. The teams exist by
+        // then, reserve estimatedBattleBytes() before building them to refuse their memory too.
+        MemoryBudget *budget = nullptr;
+        // Share nearest query answers between the attacks of the battle, the outcome is the same either way.
+        bool shareProximity = true;
+        // Lay out again the teams with Layout::Morton every that many rounds, as ninjas move. 0 means never.
+        int relayoutEvery = 0;
+        // Keep the distances between the fighters of battles of at most DistanceMatrix::MAX_FIGHTERS fighters and
+        // answer the nearest queries from them, along with the shared answers. The outcome is the same either way.
+        bool distanceMatrix = true;
+    };
+
+    struct BattleResult {
+        BattleWinner winner = BattleWinner::None;
+        int rounds = 0;
+        int survivorsA = 0;
+        int survivorsB = 0;
+        int damageDealtA = 0;
+        int damageDealtB = 0;
+        // Hit points left to each team at the end.
+        int hitPointsA = 0;
+        int hitPointsB = 0;
+    };
+
+    // One battle played round by round, keeps the liveness state of both teams between rounds. The fighters must
+    // only change through playRound while the battle is played, the proximity cache relies on it.
+    class Battle {
+    private:
+        Team *teamA;
+        Team *teamB;
+        BattleOptions options;
+        BattleResult current;
+        MemoryReservation reservation;
+        ProximityCache proximity;
+
+    public:
+        Battle(Team &teamA, Team &teamB, const BattleOptions &options = BattleOptions());
+
+        bool finished() const;
+
+        void playRound();
+
+        BattleResult result() const;
+
+        Team &getTeamA() const;
+
+        Team &getTeamB() const;
+
+        const ProximityCache &getProximity() const;
+    };
+
+    std::size_t battleBytes(const Team &teamA, const Team &teamB, const BattleOptions &options = BattleOptions());
+
+    std::size_t estimatedBattleBytes(std::size_t fightersA, std::size_t fightersB,
+                                     const BattleOptions &options = BattleOptions());
+
+    BattleResult runBattle(Team &teamA, Team &teamB, const BattleOptions &options = BattleOptions());
+
+}
+
+#endif //COWBOY_VS_NINJA_A_BATTLE_HPP
@@ -0,0 +1,185 @@
+/**
+ * @file BattleCoroutine.cpp
+ * @brief Implements the battle coroutine, its task handle and the round robin scheduler.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "BattleCoroutine.hpp"
+
+namespace ariel {
+
+/// promise_type - the coroutine starts suspended, suspends after every round and keeps its frame until destroyed.
+
+    BattleTask BattleTask::promise_type::get_return_object() {
+        return BattleTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always BattleTask::promise_type::initial_suspend() noexcept {
+        return {};
+    }
+
+    std::suspend_always BattleTask::promise_type::final_suspend() noexcept {
+        return {};
+    }
+
+    std::suspend_always BattleTask::promise_type::yield_value(int /*round*/) noexcept {
+        return {};
+    }
+
+    void BattleTask::promise_type::return_value(const BattleResult &finalResult) {
+        this->result = finalResult;
+    }
+
+    void BattleTask::promise_type::unhandled_exception() {
+        this->error = std::current_exception();
+    }
+
+/// BattleTask - owning handle of the coroutine frame.
+
+    BattleTask::BattleTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+/**
+ * @brief Destroys the coroutine frame, and with it the teams owned by the battle.
+ */
+    BattleTask::~BattleTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    BattleTask::BattleTask(BattleTask &&other) noexcept: handle(other.handle) {
+        other.handle = nullptr;
+    }
+
+    BattleTask &BattleTask::operator=(BattleTask &&other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = other.handle;
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+
+/**
+ * @brief Plays the next round of the battle.
+ * @return true while the battle has more rounds to play.
+ * @throws std::runtime_error If the task is empty (moved from).
+ * @throws The exception thrown by the battle, if any.
+ */
+    bool BattleTask::step() {
+        if (!handle) {
+            throw std::runtime_error("Error: Empty battle task.");
+        }
+        if (!handle.done()) {
+            handle.resume();
+        }
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+        return !handle.done();
+    }
+
+/**
+ * @brief Checks whether the battle finished.
+ */
+    bool BattleTask::done() const {
+        return !handle || handle.done();
+    }
+
+/**
+ * @brief Hints the processor to load the fighters of this battle, called before the battle is stepped.
+ */
+    void BattleTask::prefetch() const {
+        if (!handle || handle.done()) {
+            return;
+        }
+        for (const Team *team: {handle.promise().teamA, handle.promise().teamB}) {
+            for (const Character *fighter: team->getFighters()) {
+                __builtin_prefetch(fighter);
+            }
+        }
+    }
+
+/**
+ * @brief The outcome of a finished battle.
+ * @throws std::runtime_error If the battle did not finish yet.
+ */
+    const BattleResult &BattleTask::result() const {
+        if (!done() || !handle) {
+            throw std::runtime_error("Error: The battle is not finished.");
+        }
+        return handle.promise().result;
+    }
+
+/**
+ * @brief A battle as a coroutine that owns both teams and suspends after every round.
+ * It starts suspended, every BattleTask::step plays one round.
+ * @param teamA The team attacking first.
+ * @param teamB The team attacking second.
+ * @param options Battle options such as the maximum number of rounds.
+ * @return The task that steps the battle.
+ */
+    BattleTask battleCoroutine(Team teamA, Team teamB, BattleOptions options) {
+        Battle battle(teamA, teamB, options);
+        while (!battle.finished()) {
+            battle.playRound();
+            co_yield battle.result().rounds;
+        }
+        co_return battle.result();
+    }
+
+/**
+ * @brief Adds a battle to the scheduler.
+ * @param task The battle, must not be finished.
+ * @throws std::invalid_argument If the task is already finished.
+ */
+    void BattleScheduler::add(BattleTask task) {
+        if (task.done()) {
+            throw std::invalid_argument("Error: The battle task is already finished.");
+        }
+        running.push_back(std::move(task));
+    }
+
+/**
+ * @brief Number of battles that did not finish yet.
+ */
+    std::size_t BattleScheduler::inFlight() const {
+        return running.size();
+    }
+
+/**
+ * @brief Steps all battles round robin, one round each per pass, until every battle finished.
+ * Before a battle is stepped the fighters of the following battle are prefetched.
+ * Finished battles are swapped out, so results are collected in completion order.
+ * @return The number of rounds stepped.
+ */
+    std::size_t BattleScheduler::run() {
+        std::size_t steps = 0;
+        while (!running.empty()) {
+            std::size_t index = 0;
+            while (index < running.size()) {
+                running[(index + 1) % running.size()].prefetch();
+                steps++;
+                if (running[index].step()) {
+                    index++;
+                    continue;
+                }
+                results.push_back(running[index].result());
+                running[index] = std::move(running.back());
+                running.pop_back();
+            }
+        }
+        return steps;
+    }
+
+/**
+ * @brief Outcomes of the finished battles in completion order.
+ */
+    const std::vector<BattleResult> &BattleScheduler::getResults() const {
+        return results;
+    }
+
+}
@@ -0,0 +1,89 @@
+/**
+ * @file BattleCoroutine.hpp
+ * @brief C++20 coroutine form of a battle, suspended after every round, and a scheduler that interleaves
+ * thousands of in flight battles on one thread. While one battle is stepped the fighters of the next one are
+ * prefetched, hiding memory latency on large rosters.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_BATTLECOROUTINE_HPP
+#define COWBOY_VS_NINJA_A_BATTLECOROUTINE_HPP
+
+#include "Battle.hpp"
+#include <coroutine>
+#include <exception>
+#include <vector>
+
+namespace ariel {
+
+    class BattleTask {
+    public:
+        struct promise_type {
+            Team *teamA;
+            Team *teamB;
+            BattleResult result;
+            std::exception_ptr error;
+
+            // Receives the parameter copies of the coroutine, so the task knows which teams to prefetch.
+            promise_type(Team &teamA, Team &teamB, const BattleOptions & /*options*/) : teamA(&teamA),
+                                                                                       teamB(&teamB) {}
+
+            BattleTask get_return_object();
+
+            std::suspend_always initial_suspend() noexcept;
+
+            std::suspend_always final_suspend() noexcept;
+
+            std::suspend_always yield_value(int round) noexcept;
+
+            void return_value(const BattleResult &finalResult);
+
+            void unhandled_exception();
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit BattleTask(std::coroutine_handle<promise_type> handle);
+
+    public:
+        ~BattleTask();
+
+        BattleTask(BattleTask &&other) noexcept;
+
+        BattleTask &operator=(BattleTask &&other) noexcept;
+
+        BattleTask(const BattleTask &) = delete;
+
+        BattleTask &operator=(const BattleTask &) = delete;
+
+        bool step();
+
+        bool done() const;
+
+        void prefetch() const;
+
+        const BattleResult &result() const;
+    };
+
+    BattleTask battleCoroutine(Team teamA, Team teamB, BattleOptions options = BattleOptions());
+
+    class BattleScheduler {
+    private:
+        std::vector<BattleTask> running;
+        std::vector<BattleResult> results;
+
+    public:
+        void add(BattleTask task);
+
+        std::size_t inFlight() const;
+
+        std::size_t run();
+
+        const std::vector<BattleResult> &getResults() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_BATTLECOROUTINE_HPP
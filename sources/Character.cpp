@@ -6,9 +6,101 @@
  */
 
 #include "Character.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace ariel {
 
+    namespace {
+
+        /**
+         * @brief Positions and speeds of a batch of ninjas as separate arrays, reused between batches.
+         */
+        struct PackedNinjas {
+            std::vector<double> x;
+            std::vector<double> y;
+            std::vector<double> speed;
+
+            void resize(std::size_t count) {
+                x.resize(count);
+                y.resize(count);
+                speed.resize(count);
+            }
+        };
+
+        /**
+         * @brief Steps every position toward the target, in place. A branch free loop over plain arrays, so the
+         * compiler turns it into SIMD code. The expressions are those of move and moveTowards, and sqrt and
+         * the division are correctly rounded in vector form too, so the results are bit identical.
+         * No position may be on the target.
+         */
+        void stepTowards(double *__restrict xs, double *__restrict ys, const double *__restrict speeds,
+                         std::size_t count, double targetX, double targetY) {
+#pragma omp simd
+            for (std::size_t i = 0; i < count; i++) {
+                double dx = xs[i] - targetX;
+                double dy = ys[i] - targetY;
+                double dist = std::sqrt(dx * dx + dy * dy);
+                double movement = speeds[i] > dist ? dist : speeds[i];
+                double newX = xs[i] + movement * (targetX - xs[i]) / dist;
+                double newY = ys[i] + movement * (targetY - ys[i]) / dist;
+                bool arrived = dist <= movement;
+                xs[i] = arrived ? targetX : newX;
+                ys[i] = arrived ? targetY : newY;
+            }
+        }
+
+        /**
+         * @brief Checks the arguments of a character before its name is interned, a rejected character leaves
+         * nothing in the name pool.
+         * @return The name.
+         */
+        const std::string &checkedName(const std::string &name, const Point &location, int hitPoints) {
+            if (name.empty()) {
+                throw std::invalid_argument("Error: Name cannot be empty.");
+            }
+            if (location.getX() < 0.0 || location.getY() < 0.0) {
+                throw std::invalid_argument("Error: Location coordinates cannot be negative.");
+            }
+            if (hitPoints < 0.0 || hitPoints > 150.0) {
+                throw std::out_of_range("Error: hitPoints out of bounds.");
+            }
+            return name;
+        }
+
+        /**
+         * @brief Checks the speed of a ninja before the Character constructor interns its name.
+         * @return The name.
+         */
+        const std::string &checkedSpeed(const std::string &name, int speed) {
+            if (speed < 0) {
+                throw std::invalid_argument("Error: Speed cannot be negative.");
+            }
+            if (speed > INT16_MAX) {
+                throw std::out_of_range("Error: Speed out of bounds.");
+            }
+            return name;
+        }
+
+        /**
+         * @brief The observers of the observed characters, kept out of the characters' hot fields. Split in shards
+         * by address so indexed teams on different threads rarely share a lock.
+         */
+        struct ObserverShard {
+            std::mutex lock;
+            std::unordered_map<const Character *, FighterObserver *> byFighter;
+        };
+
+        const std::size_t OBSERVER_SHARDS = 64;
+
+        ObserverShard &observers(const Character *fighter) {
+            static ObserverShard shards[OBSERVER_SHARDS];
+            // The low bits of an address are alignment, a fighter spans 32 bytes.
+            return shards[(reinterpret_cast<std::uintptr_t>(fighter) >> 5) % OBSERVER_SHARDS];
+        }
+    }
+
 /**
  * @brief Constructs a Character object with the specified name and location.
  * @param name The name of the character.
@@ -17,20 +109,54 @@ namespace ariel {
  * @throw std::out_of_range If the hit points is over or under the range of 0-150.
  */
     Character::Character(const std::string& name, const ariel::Point& location, const int &hitPoints):
-            location(location) ,hitPoints(hitPoints) , name(name), teamMember(false){
-        if (name.empty()) {
-            throw std::invalid_argument("Error: Name cannot be empty.");
-        }
-        if (this->location.getX() < 0.0 || this->location.getY() < 0.0) {
-            throw std::invalid_argument("Error: Location coordinates cannot be negative.");
-        }
-        if (hitPoints < 0.0 || hitPoints > 150.0) {
-            throw std::out_of_range("Error: hitPoints out of bounds.");
-        }
+            location(location), nameAndFlags(NamePool::intern(checkedName(name, location, hitPoints))),
+            hitPoints(static_cast<std::int16_t>(hitPoints)) {
         this->location = location;
-        this->hitPoints = hitPoints;
-        this->name = name;
-        this->teamMember= false;
+    }
+
+/**
+ * @brief Destructor, forgets the observer of the character.
+ */
+    Character::~Character() {
+        setObserver(nullptr);
+    }
+
+/**
+ * @brief Copy constructor, the copy has no observer.
+ */
+    Character::Character(const Character &other) :
+            location(other.location), nameAndFlags(other.nameAndFlags & ~OBSERVED), hitPoints(other.hitPoints) {}
+
+/**
+ * @brief Copy assignment, keeps the observer of this character and tells it about the new state.
+ */
+    Character &Character::operator=(const Character &other) {
+        if (this != &other) {
+            Point from = this->location;
+            bool wasAlive = isAlive();
+            this->location = other.location;
+            this->hitPoints = other.hitPoints;
+            this->nameAndFlags = (other.nameAndFlags & ~OBSERVED) | (this->nameAndFlags & OBSERVED);
+            if (FighterObserver *watcher = observer()) {
+                watcher->moved(this, from);
+                if (wasAlive != isAlive()) {
+                    watcher->aliveChanged(this);
+                }
+            }
+        }
+        return *this;
+    }
+
+/**
+ * @brief Move constructor, the same as the copy constructor, a character owns nothing to move.
+ */
+    Character::Character(Character &&other) noexcept: Character(static_cast<const Character &>(other)) {}
+
+/**
+ * @brief Move assignment, the same as the copy assignment.
+ */
+    Character &Character::operator=(Character &&other) noexcept {
+        return *this = static_cast<const Character &>(other);
     }
 
 /**
@@ -45,7 +171,13 @@ namespace ariel {
         if(NewHitPoints > 150){
             throw std::out_of_range("Error:hitPoints out of bounds.");
         }
-        this->hitPoints = NewHitPoints;
+        bool wasAlive = isAlive();
+        this->hitPoints = static_cast<std::int16_t>(NewHitPoints);
+        if (wasAlive != isAlive()) {
+            if (FighterObserver *watcher = observer()) {
+                watcher->aliveChanged(this);
+            }
+        }
     }
 
 /**
@@ -78,10 +210,17 @@ namespace ariel {
             throw std::invalid_argument("Error: amount must be non-negative.");
         }
 
-        this->hitPoints -= amount;
+        bool wasAlive = isAlive();
+        int remaining = this->hitPoints - amount;
 
-        if (this->hitPoints < 0) {
-            this->hitPoints = 0;
+        if (remaining < 0) {
+            remaining = 0;
+        }
+        this->hitPoints = static_cast<std::int16_t>(remaining);
+        if (wasAlive && !isAlive()) {
+            if (FighterObserver *watcher = observer()) {
+                watcher->aliveChanged(this);
+            }
         }
     }
 
@@ -90,7 +229,15 @@ namespace ariel {
  * @return The name of the character.
  */
     std::string Character::getName() const {
-        return this->name;
+        return NamePool::text(getNameId());
+    }
+
+/**
+ * @brief Gets the handle of the name of the character in the NamePool.
+ * @return The handle.
+ */
+    NameId Character::getNameId() const {
+        return this->nameAndFlags & (OBSERVED - 1);
     }
 
 /**
@@ -114,7 +261,7 @@ namespace ariel {
  * @return true if the Character is a team member, false otherwise.
  */
     bool Character::isTeamMember() const {
-        return this->teamMember;
+        return (this->nameAndFlags & TEAM_MEMBER) != 0;
     }
 
 /**
@@ -123,14 +270,18 @@ namespace ariel {
  * Set to true if the Character is a team member, and false if the Character is not part of any team.
  */
     void Character::setTeamMember(bool newTeamMember) {
-        this->teamMember = newTeamMember;
+        if (newTeamMember) {
+            this->nameAndFlags |= TEAM_MEMBER;
+        } else {
+            this->nameAndFlags &= ~TEAM_MEMBER;
+        }
     }
 /**
  * @brief Generates a string representation of the Character.
  * @return A string representation of the Character, including the name, hit points, and location.
  */
     std::string Character::print() const {
-        std::string characterInfo = "name: "+name + ", HitPoints: "+ std::to_string(hitPoints)  + ", location: ";
+        std::string characterInfo = "name: "+getName() + ", HitPoints: "+ std::to_string(hitPoints)  + ", location: ";
         characterInfo += location.print();
         return characterInfo;
     }
@@ -143,7 +294,43 @@ namespace ariel {
         if (std::abs(newLocation.getX()) > DBL_MAX || std::abs(newLocation.getY()) > DBL_MAX) {
             throw std::out_of_range("Error: Invalid coordinates. Out of bounds.");
         }
+        Point from = this->location;
         this->location = newLocation;
+        if (FighterObserver *watcher = observer()) {
+            watcher->moved(this, from);
+        }
+    }
+
+/**
+ * @brief Sets the observer told about the moves of this character, nullptr for none.
+ * @param newObserver The observer, it must outlive the character or be reset first.
+ */
+    void Character::setObserver(FighterObserver *newObserver) {
+        if (newObserver == nullptr && (this->nameAndFlags & OBSERVED) == 0) {
+            return;
+        }
+        ObserverShard &table = observers(this);
+        std::lock_guard<std::mutex> guard(table.lock);
+        if (newObserver == nullptr) {
+            table.byFighter.erase(this);
+            this->nameAndFlags &= ~OBSERVED;
+        } else {
+            table.byFighter[this] = newObserver;
+            this->nameAndFlags |= OBSERVED;
+        }
+    }
+
+/**
+ * @brief The observer of the character, nullptr without a lookup when it has none.
+ */
+    FighterObserver *Character::observer() const {
+        if ((this->nameAndFlags & OBSERVED) == 0) {
+            return nullptr;
+        }
+        ObserverShard &table = observers(this);
+        std::lock_guard<std::mutex> guard(table.lock);
+        auto found = table.byFighter.find(this);
+        return found == table.byFighter.end() ? nullptr : found->second;
     }
 
 /// Cowboy class - defines the Cowboys class, derived from the Character class.
@@ -230,22 +417,20 @@ namespace ariel {
  * @param location The initial location of the ninja.
  * @param speed The speed of the ninja.
  * @param hitPoints The hit points of the ninja.
+ * @throws std::invalid_argument If the speed is negative.
+ * @throws std::out_of_range If the speed is above INT16_MAX or the hit points are out of 0-150.
  */
-    Ninja::Ninja(const std::string& name, const Point& location, int speed , int hitPoints) : Character(name, location,hitPoints) , speed(speed) {
-        if (speed < 0) {
-            throw std::invalid_argument("Error: Speed cannot be negative.");
-        }
+    Ninja::Ninja(const std::string& name, const Point& location, int speed , int hitPoints) :
+            Character(checkedSpeed(name, speed), location, hitPoints) , speed(static_cast<std::int16_t>(speed)) {
         if (hitPoints < 0) {
             throw std::invalid_argument("Error: Hit points cannot be negative.");
         }
-        this->speed = speed;
     }
 /**
  * @brief Moves the Ninja towards the enemy by a distance equal to its speed.
  * @param enemy A pointer to the enemy Character.
  * @throws std::invalid_argument If the enemy pointer is invalid or the distance is invalid.
  */
-
     void Ninja::move(ariel::Character *enemy) {
         if (!enemy) {
             throw std::invalid_argument("Error: Invalid pointer to enemy character.");
@@ -253,7 +438,9 @@ namespace ariel {
         if (!isAlive()) {
             return;
         }
-        double distance = getLocation().distance(enemy->getLocation());
+        const Point source = getLocation();
+        const Point target = enemy->getLocation();
+        double distance = source.distance(target);
         if (distance <= 0) {
             throw std::invalid_argument("Error: Invalid distance to enemy.");
         }
@@ -261,9 +448,88 @@ namespace ariel {
         if (movement > distance) {
             movement = distance;
         }
-        Point newLocation = Point::moveTowards(getLocation(), enemy->getLocation(), movement);
-        setLocation(newLocation);
+        setLocation(Point::moveTowards(source, target, movement));
+    }
+
+/**
+ * @brief Moves a batch of ninjas towards the same enemy, as move one after the other would.
+ * Dead ninjas do not move. The positions of large batches are packed, stepped in one vectorizable pass and written
+ * back in order.
+ * @param ninjas The ninjas, in the order move would have been called.
+ * @param enemy A pointer to the enemy Character.
+ * @throws std::invalid_argument If the enemy pointer is invalid or a living ninja stands on the enemy, the ninjas
+ * before it have moved then.
+ */
+    void Ninja::moveAll(std::span<Ninja *const> ninjas, Character *enemy) {
+        if (!enemy) {
+            throw std::invalid_argument("Error: Invalid pointer to enemy character.");
+        }
+        if (ninjas.size() < PACKED_BATCH) {
+            for (Ninja *ninja: ninjas) {
+                ninja->move(enemy);
+            }
+            return;
+        }
+        thread_local PackedNinjas packed;
+        thread_local std::vector<Ninja *> living;
+        living.clear();
+        for (Ninja *ninja: ninjas) {
+            if (ninja->isAlive()) {
+                living.push_back(ninja);
+            }
+        }
+        const double targetX = enemy->getLocation().getX();
+        const double targetY = enemy->getLocation().getY();
+        packed.resize(living.size());
+        // Locations are finite, so a zero distance is exactly a location equal to the target.
+        std::size_t invalid = living.size();
+        for (std::size_t i = 0; i < living.size(); i++) {
+            const Point location = living[i]->getLocation();
+            packed.x[i] = location.getX();
+            packed.y[i] = location.getY();
+            packed.speed[i] = static_cast<double>(living[i]->speed);
+            if (packed.x[i] == targetX && packed.y[i] == targetY) {
+                invalid = i;
+                break;
+            }
+        }
+        stepTowards(packed.x.data(), packed.y.data(), packed.speed.data(), invalid, targetX, targetY);
+        for (std::size_t i = 0; i < invalid; i++) {
+            living[i]->setLocation(Point(packed.x[i], packed.y[i]));
+        }
+        if (invalid < living.size()) {
+            throw std::invalid_argument("Error: Invalid distance to enemy.");
+        }
     }
+/**
+ * @brief Moves the Ninja towards the enemy using 16.16 fixed point integer arithmetic only.
+ * The new location is snapped to the 1/65536 grid, so replays are bit exact across compilers and machines.
+ * @param enemy A pointer to the enemy Character.
+ * @throws std::invalid_argument If the enemy pointer is invalid or both stand on the same grid position.
+ * @throws std::out_of_range If a location is outside the fixed point board or the speed is above
+ * FixedPoint::LIMIT.
+ */
+    void Ninja::moveDeterministic(ariel::Character *enemy) {
+        if (!enemy) {
+            throw std::invalid_argument("Error: Invalid pointer to enemy character.");
+        }
+        if (!isAlive()) {
+            return;
+        }
+        const FixedPoint source(getLocation());
+        const FixedPoint target(enemy->getLocation());
+        if (source == target) {
+            throw std::invalid_argument("Error: Invalid distance to enemy.");
+        }
+        // A custom speed can exceed the board, whose step would not fit the 32 bit raw value.
+        if (this->speed > FixedPoint::LIMIT) {
+            throw std::out_of_range("Error: Speed out of the fixed point range.");
+        }
+        const std::int64_t step = std::int64_t{this->speed} * FixedPoint::ONE;
+        FixedPoint newLocation = FixedPoint::moveTowards(source, target, static_cast<std::int32_t>(step));
+        setLocation(newLocation.toPoint());
+    }
+
 /**
  * @brief Performs a slash attack on the enemy character.
  * @param enemy A pointer to the enemy character.
@@ -294,4 +560,115 @@ namespace ariel {
         return " N, " + Character::print();
     }
 
-}
\ No newline at end of file
+/// Cloning - copy construction in caller provided storage, used by Team::clone.
+
+/**
+ * @brief Copy constructs this cowboy in the given storage, without revalidating it.
+ * @param storage Suitably aligned memory of at least footprint() bytes.
+ * @return The copy.
+ */
+    Character *Cowboy::cloneInto(void *storage) const {
+        return new(storage) Cowboy(*this);
+    }
+
+/**
+ * @brief Size of the storage needed by cloneInto.
+ */
+    std::size_t Cowboy::footprint() const {
+        return sizeof(Cowboy);
+    }
+
+/**
+ * @brief The kind of the fighter, used by the memory accounting.
+ */
+    FighterKind Cowboy::kind() const {
+        return FighterKind::Cowboy;
+    }
+
+/**
+ * @brief Copy constructs this ninja in the given storage, without revalidating it.
+ * @param storage Suitably aligned memory of at least footprint() bytes.
+ * @return The copy.
+ */
+    Character *Ninja::cloneInto(void *storage) const {
+        return new(storage) Ninja(*this);
+    }
+
+/**
+ * @brief Size of the storage needed by cloneInto.
+ */
+    std::size_t Ninja::footprint() const {
+        return sizeof(Ninja);
+    }
+
+/**
+ * @brief The kind of the fighter, used by the memory accounting.
+ */
+    FighterKind Ninja::kind() const {
+        return FighterKind::Ninja;
+    }
+
+/**
+ * @brief Copy constructs this young ninja in the given storage, without revalidating it.
+ */
+    Character *YoungNinja::cloneInto(void *storage) const {
+        return new(storage) YoungNinja(*this);
+    }
+
+/**
+ * @brief Size of the storage needed by cloneInto.
+ */
+    std::size_t YoungNinja::footprint() const {
+        return sizeof(YoungNinja);
+    }
+
+/**
+ * @brief The kind of the fighter, used by the memory accounting.
+ */
+    FighterKind YoungNinja::kind() const {
+        return FighterKind::YoungNinja;
+    }
+
+/**
+ * @brief Copy constructs this trained ninja in the given storage, without revalidating it.
+ */
+    Character *TrainedNinja::cloneInto(void *storage) const {
+        return new(storage) TrainedNinja(*this);
+    }
+
+/**
+ * @brief Size of the storage needed by cloneInto.
+ */
+    std::size_t TrainedNinja::footprint() const {
+        return sizeof(TrainedNinja);
+    }
+
+/**
+ * @brief The kind of the fighter, used by the memory accounting.
+ */
+    FighterKind TrainedNinja::kind() const {
+        return FighterKind::TrainedNinja;
+    }
+
+/**
+ * @brief Copy constructs this old ninja in the given storage, without revalidating it.
+ */
+    Character *OldNinja::cloneInto(void *storage) const {
+        return new(storage) OldNinja(*this);
+    }
+
+/**
+ * @brief Size of the storage needed by cloneInto.
+ */
+    std::size_t OldNinja::footprint() const {
+        return sizeof(OldNinja);
+    }
+
+/**
+ * @brief The kind of the fighter, used by the memory accounting.
+ */
+    FighterKind OldNinja::kind() const {
+        return FighterKind::OldNinja;
+    }
+
+}
@@ -8,23 +8,59 @@
 #ifndef COWBOY_VS_NINJA_A_CHARACTER_HPP
 #define COWBOY_VS_NINJA_A_CHARACTER_HPP
 
+#include <cstdint>
 #include <iostream>
+#include <span>
 #include <string>
 #include "Point.hpp"
+#include "FixedPoint.hpp"
+#include "NamePool.hpp"
 
 namespace ariel {
 
+    enum class FighterKind : std::uint8_t {
+        Cowboy = 0,
+        YoungNinja = 1,
+        TrainedNinja = 2,
+        OldNinja = 3,
+        // A ninja with a custom speed, it has no wire encoding.
+        Ninja = 4,
+        Count
+    };
+
+    class Character;
+
+    // Told about changes of fighters that a spatial index holds, see Character::setObserver.
+    class FighterObserver {
+    public:
+        virtual ~FighterObserver() = default;
+
+        virtual void moved(Character *fighter, const Point &from) = 0;
+
+        // The fighter died or was brought back to life.
+        virtual void aliveChanged(Character *fighter) = 0;
+    };
+
     class Character {
     private:
+        // Only the fields the battle loops read, two fighters share a 64 byte cache line. The name text lives in
+        // the NamePool and the observer in a side table, looked up only while the OBSERVED flag is set.
         Point location;
-        int hitPoints;
-        std::string name;
-        bool teamMember;
+        // The NameId in the low 30 bits, the flags below in the top two.
+        std::uint32_t nameAndFlags;
+        // Between 0 and 150. Last, so the fields of the subclasses fill the padding after it.
+        std::int16_t hitPoints;
+
+        static constexpr std::uint32_t TEAM_MEMBER = std::uint32_t{1} << 31;
+        // Not copied, a copy starts unobserved.
+        static constexpr std::uint32_t OBSERVED = std::uint32_t{1} << 30;
+
+        FighterObserver *observer() const;
 
     public:
         Character(const std::string &name, const Point &location, const int &hitPoints);
 
-        virtual ~Character() = default;
+        virtual ~Character();
 
         void setHitPoints(int NewHitPoints);
 
@@ -36,6 +72,8 @@ namespace ariel {
 
         std::string getName() const;
 
+        NameId getNameId() const;
+
         Point getLocation() const;
 
         int getHitPoints() const;
@@ -46,22 +84,30 @@ namespace ariel {
 
         void setLocation(Point newLocation);
 
+        void setObserver(FighterObserver *newObserver);
+
         virtual std::string print() const = 0;
 
+        // Copy constructs this character, with its dynamic type, in storage of at least footprint() bytes.
+        virtual Character *cloneInto(void *storage) const = 0;
+
+        virtual std::size_t footprint() const = 0;
+
+        virtual FighterKind kind() const = 0;
 
         // Make tidy make me do that
-        Character(const Character &other) = default;
+        Character(const Character &other);
 
-        Character &operator=(const Character &other) = default;
+        Character &operator=(const Character &other);
 
-        Character(Character &&other) = default;
+        Character(Character &&other) noexcept;
 
-        Character &operator=(Character &&other) = default;
+        Character &operator=(Character &&other) noexcept;
     };
 
     class Cowboy : public Character {
     private:
-        int bullets;
+        std::int16_t bullets;
 
     public:
         Cowboy(const std::string &name, const Point &location);
@@ -75,21 +121,40 @@ namespace ariel {
         int getBullets() const;
 
         std::string print() const override;
+
+        Character *cloneInto(void *storage) const override;
+
+        std::size_t footprint() const override;
+
+        FighterKind kind() const override;
     };
 
     class Ninja : public Character {
     private:
-        int speed;
+        // Smaller batches move one by one, packing their positions costs more than it saves.
+        static const std::size_t PACKED_BATCH = 64;
+
+        std::int16_t speed;
 
     public:
         Ninja(const std::string &name, const Point &location, int speed, int hitPoints);
 
         void move(Character *enemy);
 
+        void moveDeterministic(Character *enemy);
+
+        // Same result as calling move(enemy) on each ninja in order, computed in one pass over packed positions.
+        static void moveAll(std::span<Ninja *const> ninjas, Character *enemy);
+
         void slash(Character *enemy);
 
         std::string print() const override;
 
+        Character *cloneInto(void *storage) const override;
+
+        std::size_t footprint() const override;
+
+        FighterKind kind() const override;
     };
 
     class YoungNinja : public Ninja {
@@ -100,6 +165,12 @@ namespace ariel {
     public:
         YoungNinja(const std::string &name, const Point &location) : Ninja(name, location, YOUNG_NINJA_SPEED,
                                                                            YOUNG_NINJA_HIT_POINTS) {}
+
+        Character *cloneInto(void *storage) const override;
+
+        std::size_t footprint() const override;
+
+        FighterKind kind() const override;
     };
 
     class TrainedNinja : public Ninja {
@@ -109,6 +180,12 @@ namespace ariel {
     public:
         TrainedNinja(const std::string &name, const Point &location) : Ninja(name, location, TRAINED_NINJA_SPEED,
                                                                              TRAINED_NINJA_HIT_POINTS) {}
+
+        Character *cloneInto(void *storage) const override;
+
+        std::size_t footprint() const override;
+
+        FighterKind kind() const override;
     };
 
     class OldNinja : public Ninja {
@@ -118,7 +195,16 @@ namespace ariel {
     public:
         OldNinja(const std::string &name, const Point &location) : Ninja(name, location, OLD_NINJA_SPEED,
                                                                          OLD_NINJA_HIT_POINTS) {}
+
+        Character *cloneInto(void *storage) const override;
+
+        std::size_t footprint() const override;
+
+        FighterKind kind() const override;
     };
+
+    static_assert(sizeof(Cowboy) <= 32 && sizeof(YoungNinja) <= 32 && sizeof(TrainedNinja) <= 32 &&
+                  sizeof(OldNinja) <= 32, "Error: A fighter no longer fits twice in a 64 byte cache line.");
 }
 
 #endif // COWBOY_VS_NINJA_A_CHARACTER_HPP
@@ -0,0 +1,132 @@
+/**
+ * @file DistanceMatrix.cpp
+ * @brief Implements the distance matrix of a small battle.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "DistanceMatrix.hpp"
+
+namespace ariel {
+
+/**
+ * @brief Whether the fighters of two teams fit in a matrix.
+ */
+    bool DistanceMatrix::fits(const Team &first, const Team &second) {
+        return first.getFighters().size() + second.getFighters().size() <= MAX_FIGHTERS;
+    }
+
+/**
+ * @brief Takes in the fighters of two teams, every distance is stale until first read.
+ * @return true if they fit in the matrix, false leaves it detached.
+ */
+    bool DistanceMatrix::attach(const Team &first, const Team &second) {
+        detach();
+        if (!fits(first, second)) {
+            return false;
+        }
+        const std::vector<Character *> &firstFighters = first.getFighters();
+        const std::vector<Character *> &secondFighters = second.getFighters();
+        teams = {&first, &second};
+        firstSize = firstFighters.size();
+        size = firstSize + secondFighters.size();
+        clock++;
+        for (std::size_t i = 0; i < size; i++) {
+            fighters[i] = i < firstSize ? firstFighters[i] : secondFighters[i - firstSize];
+            xs[i] = fighters[i]->getLocation().getX();
+            ys[i] = fighters[i]->getLocation().getY();
+            movedAt[i] = clock;
+        }
+        return true;
+    }
+
+/**
+ * @brief Forgets the fighters, every query falls back to a scan.
+ */
+    void DistanceMatrix::detach() {
+        teams = {nullptr, nullptr};
+        firstSize = 0;
+        size = 0;
+        lastRow = 0;
+    }
+
+/**
+ * @brief Whether the matrix holds the fighters of a battle.
+ */
+    bool DistanceMatrix::attached() const {
+        return size > 0;
+    }
+
+/**
+ * @brief Takes the new location of a fighter that moved, its row and column become stale.
+ */
+    void DistanceMatrix::moved(const Character *fighter) {
+        for (std::size_t i = 0; i < size; i++) {
+            if (fighters[i] == fighter) {
+                xs[i] = fighter->getLocation().getX();
+                ys[i] = fighter->getLocation().getY();
+                movedAt[i] = ++clock;
+                return;
+            }
+        }
+    }
+
+/**
+ * @brief The closest living fighter of a team from the location of one of the fighters, by one row of the matrix.
+ * The answer is the one of Team::findClosestCharacter: the first of the closest in turn order. Entries are
+ * computed by Point::distance, which gives the same value both ways, so a row holds exactly what a scan from that
+ * fighter's location computes.
+ * @param origin The location searched from.
+ * @param owner The team searched.
+ * @param answer Set to the closest living fighter, nullptr if none is alive, when the matrix can answer.
+ * @return false if the matrix cannot answer: the team is not attached or no fighter stands at origin.
+ */
+    bool DistanceMatrix::nearest(const Point &origin, const Team &owner, Character *&answer) {
+        if (size == 0 || (teams[0] != &owner && teams[1] != &owner)) {
+            return false;
+        }
+        std::size_t row = lastRow;
+        if (xs[row] != origin.getX() || ys[row] != origin.getY()) {
+            for (row = 0; row < size; row++) {
+                if (xs[row] == origin.getX() && ys[row] == origin.getY()) {
+                    break;
+                }
+            }
+            if (row == size) {
+                return false;
+            }
+            lastRow = row;
+        }
+        std::size_t begin = teams[0] == &owner ? 0 : firstSize;
+        std::size_t end = teams[0] == &owner ? firstSize : size;
+        Character *closest = nullptr;
+        double closestDistance = std::numeric_limits<double>::max();
+        for (std::size_t j = begin; j < end; j++) {
+            if (!fighters[j]->isAlive()) {
+                continue;
+            }
+            if (computedAt[row][j] < movedAt[row] || computedAt[row][j] < movedAt[j]) {
+                double distance = origin.distance(Point(xs[j], ys[j]));
+                distances[row][j] = distance;
+                distances[j][row] = distance;
+                computedAt[row][j] = clock;
+                computedAt[j][row] = clock;
+            }
+            if (distances[row][j] < closestDistance) {
+                closest = fighters[j];
+                closestDistance = distances[row][j];
+            }
+        }
+        answer = closest;
+        answered++;
+        return true;
+    }
+
+/**
+ * @brief Number of queries answered by the matrix.
+ */
+    std::size_t DistanceMatrix::answers() const {
+        return answered;
+    }
+
+}
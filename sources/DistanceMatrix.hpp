@@ -0,0 +1,61 @@
+/**
+ * @file DistanceMatrix.hpp
+ * @brief Pairwise distances between the fighters of a small battle, recomputed only after one of the two moved.
+ * In the classic ten against ten battle the same distances are computed over and over, cowboys never move and a
+ * ninja only moves on its own turn. The matrix keeps all of them with the time each was computed, a fighter
+ * reported as moved makes its row and column stale, and the nearest fighter from a fighter's location is a scan
+ * of one row that recomputes the stale entries it reads.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_DISTANCEMATRIX_HPP
+#define COWBOY_VS_NINJA_A_DISTANCEMATRIX_HPP
+
+#include "Team.hpp"
+#include <array>
+#include <cstdint>
+
+namespace ariel {
+
+    class DistanceMatrix {
+    public:
+        static constexpr std::size_t MAX_FIGHTERS = 20;
+
+    private:
+        // The fighters of the first team, then those of the second, each in turn order.
+        std::array<Character *, MAX_FIGHTERS> fighters{};
+        // Locations at the last move, as reported by moved().
+        std::array<double, MAX_FIGHTERS> xs{};
+        std::array<double, MAX_FIGHTERS> ys{};
+        std::array<std::array<double, MAX_FIGHTERS>, MAX_FIGHTERS> distances{};
+        // An entry is fresh while it was computed no earlier than the last move of both fighters.
+        std::array<std::array<std::uint64_t, MAX_FIGHTERS>, MAX_FIGHTERS> computedAt{};
+        std::array<std::uint64_t, MAX_FIGHTERS> movedAt{};
+        std::uint64_t clock = 0;
+        std::array<const Team *, 2> teams{};
+        std::size_t firstSize = 0;
+        std::size_t size = 0;
+        // The row of the last query, leaders ask again and again from the same place.
+        std::size_t lastRow = 0;
+        std::size_t answered = 0;
+
+    public:
+        static bool fits(const Team &first, const Team &second);
+
+        bool attach(const Team &first, const Team &second);
+
+        void detach();
+
+        bool attached() const;
+
+        void moved(const Character *fighter);
+
+        bool nearest(const Point &origin, const Team &owner, Character *&answer);
+
+        std::size_t answers() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_DISTANCEMATRIX_HPP
@@ -0,0 +1,55 @@
+/**
+ * @file FighterArena.cpp
+ * @brief Implements the reusable fighter memory.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "FighterArena.hpp"
+#include <stdexcept>
+
+namespace ariel {
+
+/**
+ * @brief Forgets what was allocated and makes room for at least bytes, the memory is only reallocated to grow.
+ * No team may still use the arena.
+ * @param bytes The room needed, every allocation rounded up to alignof(std::max_align_t).
+ */
+    void FighterArena::reset(std::size_t bytes) {
+        if (bytes > capacity) {
+            storage = std::make_unique<std::byte[]>(bytes);
+            capacity = bytes;
+        }
+        used = 0;
+    }
+
+/**
+ * @brief Storage for one fighter, aligned like new would align it.
+ * @throws std::length_error If the room given to reset() is used up.
+ */
+    void *FighterArena::allocate(std::size_t bytes) {
+        const std::size_t alignment = alignof(std::max_align_t);
+        std::size_t rounded = (bytes + alignment - 1) / alignment * alignment;
+        if (rounded > capacity - used) {
+            throw std::length_error("Error: The fighter arena is full.");
+        }
+        void *memory = storage.get() + used;
+        used += rounded;
+        return memory;
+    }
+
+/**
+ * @brief The start of the memory, the fighters allocated so far lie in [data(), data() + size()).
+ */
+    std::byte *FighterArena::data() const {
+        return storage.get();
+    }
+
+/**
+ * @brief Bytes of memory held, allocated or not.
+ */
+    std::size_t FighterArena::size() const {
+        return capacity;
+    }
+
+}
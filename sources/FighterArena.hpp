@@ -0,0 +1,36 @@
+/**
+ * @file FighterArena.hpp
+ * @brief Memory reused for the fighters of one team after another, e.g. the teams a server builds for every request.
+ * Fighters are constructed in place in it, a team built on it destroys them in place and leaves the memory to the
+ * arena. The arena must outlive the teams built on it and is reset only once they are gone.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_FIGHTERARENA_HPP
+#define COWBOY_VS_NINJA_A_FIGHTERARENA_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace ariel {
+
+    class FighterArena {
+    private:
+        std::unique_ptr<std::byte[]> storage;
+        std::size_t capacity = 0;
+        std::size_t used = 0;
+
+    public:
+        void reset(std::size_t bytes);
+
+        void *allocate(std::size_t bytes);
+
+        std::byte *data() const;
+
+        std::size_t size() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_FIGHTERARENA_HPP
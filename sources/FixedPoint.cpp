@@ -0,0 +1,143 @@
+/**
+ * @file FixedPoint.cpp
+ * @brief Integer only arithmetic on 16.16 fixed point positions, bit exact on every compiler and machine.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "FixedPoint.hpp"
+
+namespace ariel {
+
+/**
+ * @brief Constructs a fixed point position, rounding each coordinate to the nearest 1/65536.
+ * @throws std::out_of_range If a coordinate is outside [-16384, 16384).
+ */
+    FixedPoint::FixedPoint(double coordinate_x, double coordinate_y) : raw_x(toFixed(coordinate_x)),
+                                                                      raw_y(toFixed(coordinate_y)) {}
+
+/**
+ * @brief Converts a board Point to fixed point.
+ * @throws std::out_of_range If a coordinate is outside [-16384, 16384).
+ */
+    FixedPoint::FixedPoint(const Point &point) : FixedPoint(point.getX(), point.getY()) {}
+
+/**
+ * @brief Constructs a position from raw 16.16 values.
+ * @throws std::out_of_range If a coordinate is outside [-16384, 16384).
+ */
+    FixedPoint FixedPoint::fromRaw(std::int32_t raw_x, std::int32_t raw_y) {
+        const std::int32_t bound = LIMIT * ONE;
+        if (raw_x < -bound || raw_x >= bound || raw_y < -bound || raw_y >= bound) {
+            throw std::out_of_range("Invalid coordinates: Out of fixed point bounds.");
+        }
+        return {raw_x, raw_y, true};
+    }
+
+/**
+ * @brief Rounds a coordinate to the nearest raw 16.16 value.
+ * @throws std::out_of_range If the value is not finite or outside [-16384, 16384).
+ */
+    std::int32_t FixedPoint::toFixed(double value) {
+        if (!std::isfinite(value) || value < -LIMIT || value >= LIMIT) {
+            throw std::out_of_range("Invalid coordinates: Out of fixed point bounds.");
+        }
+        return static_cast<std::int32_t>(std::lround(std::ldexp(value, FRACTION_BITS)));
+    }
+
+/**
+ * @brief Getter for the raw x coordinate.
+ */
+    std::int32_t FixedPoint::getRawX() const {
+        return this->raw_x;
+    }
+
+/**
+ * @brief Getter for the raw y coordinate.
+ */
+    std::int32_t FixedPoint::getRawY() const {
+        return this->raw_y;
+    }
+
+/**
+ * @brief Converts back to a board Point, exact since every 16.16 value is a double.
+ */
+    Point FixedPoint::toPoint() const {
+        return {std::ldexp(static_cast<double>(raw_x), -FRACTION_BITS),
+                std::ldexp(static_cast<double>(raw_y), -FRACTION_BITS)};
+    }
+
+/**
+ * @brief Squared distance in raw units (2^-32 board units), use it to compare distances without sqrt.
+ */
+    std::int64_t FixedPoint::squaredDistance(const FixedPoint &other) const {
+        std::int64_t dx = std::int64_t{this->raw_x} - other.raw_x;
+        std::int64_t dy = std::int64_t{this->raw_y} - other.raw_y;
+        return dx * dx + dy * dy;
+    }
+
+/**
+ * @brief Distance in raw 16.16 units, rounded down.
+ */
+    std::int32_t FixedPoint::distance(const FixedPoint &other) const {
+        return static_cast<std::int32_t>(isqrt(static_cast<std::uint64_t>(squaredDistance(other))));
+    }
+
+/**
+ * @brief Integer square root, rounded down.
+ * @param value The value.
+ * @return The largest r such that r * r <= value.
+ */
+    std::uint64_t FixedPoint::isqrt(std::uint64_t value) {
+        std::uint64_t result = 0;
+        std::uint64_t bit = std::uint64_t{1} << 62U;
+        while (bit > value) {
+            bit >>= 2U;
+        }
+        while (bit != 0) {
+            if (value >= result + bit) {
+                value -= result + bit;
+                result = (result >> 1U) + bit;
+            } else {
+                result >>= 1U;
+            }
+            bit >>= 2U;
+        }
+        return result;
+    }
+
+/**
+ * @brief Deterministic step: the point at most distance raw units from source on the way to dest.
+ * Divisions truncate toward zero, so the step never overshoots dest.
+ * @param source The source position.
+ * @param dest The destination position.
+ * @param distance The maximum step in raw 16.16 units.
+ * @return dest if it is within distance, otherwise the truncated point on the segment.
+ * @throws std::invalid_argument If distance is negative or source and dest are the same position.
+ */
+    FixedPoint FixedPoint::moveTowards(const FixedPoint &source, const FixedPoint &dest, std::int32_t distance) {
+        if (distance < 0) {
+            throw std::invalid_argument("maxDist cannot be negative");
+        }
+        if (source == dest) {
+            throw std::invalid_argument("source and dest cannot be the same position");
+        }
+        std::int64_t squared = source.squaredDistance(dest);
+        if (squared <= std::int64_t{distance} * distance) {
+            return dest;
+        }
+        auto length = static_cast<std::int64_t>(isqrt(static_cast<std::uint64_t>(squared)));
+        std::int64_t dx = std::int64_t{dest.raw_x} - source.raw_x;
+        std::int64_t dy = std::int64_t{dest.raw_y} - source.raw_y;
+        return {static_cast<std::int32_t>(source.raw_x + dx * distance / length),
+                static_cast<std::int32_t>(source.raw_y + dy * distance / length), true};
+    }
+
+/**
+ * @brief Two fixed points are equal when their raw coordinates are equal.
+ */
+    bool FixedPoint::operator==(const FixedPoint &other) const {
+        return this->raw_x == other.raw_x && this->raw_y == other.raw_y;
+    }
+
+}
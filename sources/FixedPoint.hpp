@@ -0,0 +1,57 @@
+/**
+ * @file FixedPoint.hpp
+ * @brief A 16.16 fixed point board position for deterministic, integer only movement and distance comparisons.
+ * Coordinates must lie in [-16384, 16384) so squared distances fit in 64 bits.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_FIXEDPOINT_HPP
+#define COWBOY_VS_NINJA_A_FIXEDPOINT_HPP
+
+#include "Point.hpp"
+#include <cstdint>
+
+namespace ariel {
+
+    class FixedPoint {
+    public:
+        static const int FRACTION_BITS = 16;
+        static const std::int32_t ONE = std::int32_t{1} << FRACTION_BITS;
+        static const std::int32_t LIMIT = 16384;
+
+    private:
+        std::int32_t raw_x;
+        std::int32_t raw_y;
+
+        FixedPoint(std::int32_t raw_x, std::int32_t raw_y, bool /*raw*/) : raw_x(raw_x), raw_y(raw_y) {}
+
+    public:
+        FixedPoint(double coordinate_x, double coordinate_y);
+
+        explicit FixedPoint(const Point &point);
+
+        static FixedPoint fromRaw(std::int32_t raw_x, std::int32_t raw_y);
+
+        static std::int32_t toFixed(double value);
+
+        std::int32_t getRawX() const;
+
+        std::int32_t getRawY() const;
+
+        Point toPoint() const;
+
+        std::int64_t squaredDistance(const FixedPoint &other) const;
+
+        std::int32_t distance(const FixedPoint &other) const;
+
+        static std::uint64_t isqrt(std::uint64_t value);
+
+        static FixedPoint moveTowards(const FixedPoint &source, const FixedPoint &dest, std::int32_t distance);
+
+        bool operator==(const FixedPoint &other) const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_FIXEDPOINT_HPP
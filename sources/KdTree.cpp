@@ -0,0 +1,137 @@
+/**
+ * @file KdTree.cpp
+ * @brief Builds the k-d tree by median splits and answers nearest queries with exact pruning.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "KdTree.hpp"
+#include <algorithm>
+
+namespace ariel {
+
+/**
+ * @brief Replaces the content of the tree, in O(n log n).
+ * @param fighters The fighters with their locations at build time and their team order.
+ */
+    void KdTree::build(std::vector<IndexedFighter> fighters) {
+        nodes = std::move(fighters);
+        build(0, nodes.size(), true);
+    }
+
+    void KdTree::build(std::size_t low, std::size_t high, bool splitX) {
+        if (high - low <= 1) {
+            return;
+        }
+        std::size_t middle = low + (high - low) / 2;
+        auto begin = nodes.begin();
+        std::nth_element(begin + static_cast<std::ptrdiff_t>(low), begin + static_cast<std::ptrdiff_t>(middle),
+                         begin + static_cast<std::ptrdiff_t>(high),
+                         [splitX](const IndexedFighter &first, const IndexedFighter &second) {
+                             return splitX ? first.location.getX() < second.location.getX()
+                                           : first.location.getY() < second.location.getY();
+                         });
+        build(low, middle, !splitX);
+        build(middle + 1, high, !splitX);
+    }
+
+/**
+ * @brief Collects space for k nearest answers in the caller's storage.
+ */
+    NearestHits::NearestHits(std::span<NearestHit> storage) : hits(storage), count(0) {}
+
+    namespace {
+        bool nearer(const NearestHit &first, const NearestHit &second) {
+            return first.distance < second.distance ||
+                   (first.distance == second.distance && first.order < second.order);
+        }
+    }
+
+/**
+ * @brief Keeps the fighter if it is among the k nearest so far, ranked by distance then by team order.
+ */
+    void NearestHits::offer(Character *candidate, double candidateDistance, std::uint32_t candidateOrder) {
+        NearestHit hit{candidate, candidateDistance, candidateOrder};
+        auto begin = hits.begin();
+        if (count < hits.size()) {
+            hits[count++] = hit;
+            std::push_heap(begin, begin + static_cast<std::ptrdiff_t>(count), nearer);
+        } else if (count > 0 && nearer(hit, hits[0])) {
+            std::pop_heap(begin, begin + static_cast<std::ptrdiff_t>(count), nearer);
+            hits[count - 1] = hit;
+            std::push_heap(begin, begin + static_cast<std::ptrdiff_t>(count), nearer);
+        }
+    }
+
+/**
+ * @brief The distance of the k-th nearest so far, fighters farther than it are not kept.
+ */
+    double NearestHits::bound() const {
+        if (hits.empty()) {
+            return -1;
+        }
+        return count < hits.size() ? std::numeric_limits<double>::max() : hits[0].distance;
+    }
+
+/**
+ * @brief Sorts the kept fighters nearest first.
+ * @return How many were found, at most k.
+ */
+    std::size_t NearestHits::finish() {
+        std::sort_heap(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(count), nearer);
+        return count;
+    }
+
+/**
+ * @brief Offers the living fighters of the tree to a collector, skipping subtrees beyond its bound.
+ * Distances are computed by Point::distance like in the linear scan, so the answers are the same fighters.
+ * @param origin The location to search from.
+ * @param collector The answers so far, updated in place.
+ */
+    template<typename Collector>
+    void KdTree::collect(const Point &origin, Collector &collector) const {
+        search(origin, 0, nodes.size(), true, collector);
+    }
+
+    template void KdTree::collect(const Point &origin, NearestCandidate &collector) const;
+
+    template void KdTree::collect(const Point &origin, NearestHits &collector) const;
+
+    template void KdTree::collect(const Point &origin, RadiusQuery &collector) const;
+
+    template<typename Collector>
+    void KdTree::search(const Point &origin, std::size_t low, std::size_t high, bool splitX,
+                        Collector &collector) const {
+        if (low >= high) {
+            return;
+        }
+        std::size_t middle = low + (high - low) / 2;
+        const IndexedFighter &node = nodes[middle];
+        if (node.fighter->isAlive()) {
+            collector.offer(node.fighter, origin.distance(node.location), node.order);
+        }
+        double offset = splitX ? origin.getX() - node.location.getX() : origin.getY() - node.location.getY();
+        bool nearLow = offset < 0;
+        search(origin, nearLow ? low : middle + 1, nearLow ? middle : high, !splitX, collector);
+        // Every fighter beyond the split is at least |offset| away, also after rounding. Equal distances are
+        // still searched, a lower team order may win the tie.
+        if (std::abs(offset) <= collector.bound()) {
+            search(origin, nearLow ? middle + 1 : low, nearLow ? high : middle, !splitX, collector);
+        }
+    }
+
+/**
+ * @brief Number of fighters in the tree, dead ones included.
+ */
+    std::size_t KdTree::size() const {
+        return nodes.size();
+    }
+
+/**
+ * @brief Bytes held by the nodes of the tree.
+ */
+    std::size_t KdTree::bytes() const {
+        return nodes.capacity() * sizeof(IndexedFighter);
+    }
+
+}
@@ -0,0 +1,123 @@
+/**
+ * @file KdTree.hpp
+ * @brief A static, balanced 2-d tree of fighters for nearest living fighter queries.
+ * Built once over fighters that do not move, dead fighters stay in the tree and are skipped by the queries.
+ * Queries offer fighters to a collector: the nearest one, the k nearest ones or the ones within a radius.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_KDTREE_HPP
+#define COWBOY_VS_NINJA_A_KDTREE_HPP
+
+#include "Character.hpp"
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace ariel {
+
+    struct IndexedFighter {
+        Point location;
+        Character *fighter;
+        // Position of the fighter in its team, ties between equal distances go to the lowest one.
+        std::uint32_t order;
+    };
+
+    // The best answer so far of a nearest query, ordered like a linear scan: by distance, then by team order.
+    struct NearestCandidate {
+        Character *fighter = nullptr;
+        double distance = std::numeric_limits<double>::max();
+        std::uint32_t order = std::numeric_limits<std::uint32_t>::max();
+
+        void offer(Character *candidate, double candidateDistance, std::uint32_t candidateOrder) {
+            if (candidateDistance < distance || (candidateDistance == distance && candidateOrder < order)) {
+                fighter = candidate;
+                distance = candidateDistance;
+                order = candidateOrder;
+            }
+        }
+
+        // Fighters farther than this cannot improve the answer.
+        double bound() const {
+            return distance;
+        }
+    };
+
+    // A fighter found by a k nearest query, with its distance and its position in its team.
+    struct NearestHit {
+        Character *fighter;
+        double distance;
+        std::uint32_t order;
+    };
+
+    // The best k answers so far of a k nearest query, a max heap in storage owned by the caller, k its size.
+    class NearestHits {
+    private:
+        std::span<NearestHit> hits;
+        std::size_t count;
+
+    public:
+        explicit NearestHits(std::span<NearestHit> storage);
+
+        void offer(Character *candidate, double candidateDistance, std::uint32_t candidateOrder);
+
+        double bound() const;
+
+        std::size_t finish();
+    };
+
+    // Hands every offered fighter within a radius to a visitor. The visitor is referenced, not copied, so
+    // visiting never allocates, and it must outlive the query.
+    class RadiusQuery {
+    private:
+        double radius;
+        void *visitor;
+        void (*call)(void *visitor, Character *fighter, double distance);
+
+    public:
+        template<typename Visitor>
+        RadiusQuery(double radius, Visitor &visitor) :
+                radius(radius), visitor(const_cast<void *>(static_cast<const void *>(&visitor))),
+                call([](void *target, Character *fighter, double distance) {
+                    (*static_cast<Visitor *>(target))(fighter, distance);
+                }) {}
+
+        void offer(Character *candidate, double candidateDistance, std::uint32_t /*candidateOrder*/) {
+            if (candidateDistance <= radius) {
+                call(visitor, candidate, candidateDistance);
+            }
+        }
+
+        double bound() const {
+            return radius;
+        }
+    };
+
+    class KdTree {
+    private:
+        // Implicit tree: the node of [low, high) is at the middle, its children are the two halves around it.
+        std::vector<IndexedFighter> nodes;
+
+        void build(std::size_t low, std::size_t high, bool splitX);
+
+        template<typename Collector>
+        void search(const Point &origin, std::size_t low, std::size_t high, bool splitX,
+                    Collector &collector) const;
+
+    public:
+        void build(std::vector<IndexedFighter> fighters);
+
+        // Collector is NearestCandidate, NearestHits or RadiusQuery.
+        template<typename Collector>
+        void collect(const Point &origin, Collector &collector) const;
+
+        std::size_t size() const;
+
+        std::size_t bytes() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_KDTREE_HPP
@@ -0,0 +1,290 @@
+/**
+ * @file LooseQuadtree.cpp
+ * @brief Implements the loose quadtree: construction, incremental updates and nearest queries.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "LooseQuadtree.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace ariel {
+
+    namespace {
+        const std::size_t FIGHTERS_PER_LEAF = 8;
+        const std::size_t MAX_DEPTH = 10;
+    }
+
+/**
+ * @brief Checks whether a location lies within the box, edges included.
+ */
+    bool LooseQuadtree::Box::contains(const Point &location) const {
+        return location.getX() >= minX && location.getX() <= maxX &&
+               location.getY() >= minY && location.getY() <= maxY;
+    }
+
+/**
+ * @brief Distance from a location to the box, 0 inside.
+ * Computed like Point::distance from the nearest coordinates of the box, so it never exceeds the computed
+ * distance to a location inside the box.
+ */
+    double LooseQuadtree::Box::distance(const Point &origin) const {
+        double dx = 0;
+        double dy = 0;
+        if (origin.getX() < minX) {
+            dx = origin.getX() - minX;
+        } else if (origin.getX() > maxX) {
+            dx = origin.getX() - maxX;
+        }
+        if (origin.getY() < minY) {
+            dy = origin.getY() - minY;
+        } else if (origin.getY() > maxY) {
+            dy = origin.getY() - maxY;
+        }
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+/**
+ * @brief Rebuilds the tree around the fighters. Dead fighters are remembered but only enter the tree if revived.
+ * @param fighters The fighters with their locations and team order.
+ */
+    void LooseQuadtree::build(const std::vector<IndexedFighter> &fighters) {
+        locators.clear();
+        outside.clear();
+        double minX = 0;
+        double minY = 0;
+        double maxX = 0;
+        double maxY = 0;
+        std::size_t living = 0;
+        for (const IndexedFighter &entry: fighters) {
+            if (entry.fighter->isAlive()) {
+                double x = entry.location.getX();
+                double y = entry.location.getY();
+                minX = living == 0 ? x : std::min(minX, x);
+                minY = living == 0 ? y : std::min(minY, y);
+                maxX = living == 0 ? x : std::max(maxX, x);
+                maxY = living == 0 ? y : std::max(maxY, y);
+                living++;
+            }
+        }
+        depth = 0;
+        while (depth < MAX_DEPTH && (std::size_t{1} << (2 * depth)) * FIGHTERS_PER_LEAF < living) {
+            depth++;
+        }
+        // A quarter of slack on every side, ninjas walk out of the box of their starting positions.
+        double side = std::max(maxX - minX, maxY - minY) * 1.5 + 1;
+        originX = (minX + maxX) / 2 - side / 2;
+        originY = (minY + maxY) / 2 - side / 2;
+        std::size_t leafSide = std::size_t{1} << depth;
+        cellSize = side / static_cast<double>(leafSide);
+
+        boxes.assign(depth + 1, {});
+        counts.assign(depth + 1, {});
+        for (std::size_t level = 0; level <= depth; level++) {
+            std::size_t nodes = std::size_t{1} << (2 * level);
+            boxes[level].resize(nodes);
+            counts[level].assign(nodes, 0);
+        }
+        for (std::size_t y = 0; y < leafSide; y++) {
+            for (std::size_t x = 0; x < leafSide; x++) {
+                double cellX = originX + static_cast<double>(x) * cellSize;
+                double cellY = originY + static_cast<double>(y) * cellSize;
+                boxes[depth][y * leafSide + x] = {cellX - cellSize / 2, cellY - cellSize / 2,
+                                                  cellX + cellSize * 1.5, cellY + cellSize * 1.5};
+            }
+        }
+        // Parents are the union of their children, so a subtree never reaches out of its box after rounding.
+        for (std::size_t level = depth; level > 0; level--) {
+            std::size_t childSide = std::size_t{1} << level;
+            for (std::size_t y = 0; y < childSide / 2; y++) {
+                for (std::size_t x = 0; x < childSide / 2; x++) {
+                    Box box = boxes[level][2 * y * childSide + 2 * x];
+                    for (std::size_t child = 1; child < 4; child++) {
+                        const Box &other = boxes[level][(2 * y + child / 2) * childSide + 2 * x + child % 2];
+                        box = {std::min(box.minX, other.minX), std::min(box.minY, other.minY),
+                               std::max(box.maxX, other.maxX), std::max(box.maxY, other.maxY)};
+                    }
+                    boxes[level - 1][y * (childSide / 2) + x] = box;
+                }
+            }
+        }
+        leaves.assign(std::size_t{1} << (2 * depth), {});
+        for (const IndexedFighter &entry: fighters) {
+            locators[entry.fighter] = {ABSENT, 0, entry.order};
+            if (entry.fighter->isAlive()) {
+                insert(entry);
+            }
+        }
+    }
+
+/**
+ * @brief The leaf whose loose box holds a location, OUTSIDE if there is none.
+ */
+    std::uint32_t LooseQuadtree::leafOf(const Point &location) const {
+        double maxIndex = static_cast<double>((std::size_t{1} << depth) - 1);
+        double cellX = std::clamp(std::floor((location.getX() - originX) / cellSize), 0.0, maxIndex);
+        double cellY = std::clamp(std::floor((location.getY() - originY) / cellSize), 0.0, maxIndex);
+        auto leaf = static_cast<std::uint32_t>(static_cast<std::size_t>(cellY) * (std::size_t{1} << depth) +
+                                               static_cast<std::size_t>(cellX));
+        return boxes[depth][leaf].contains(location) ? leaf : OUTSIDE;
+    }
+
+    void LooseQuadtree::insert(const IndexedFighter &entry) {
+        Locator &locator = locators[entry.fighter];
+        locator.leaf = leafOf(entry.location);
+        std::vector<IndexedFighter> &bucket = locator.leaf == OUTSIDE ? outside : leaves[locator.leaf];
+        locator.slot = static_cast<std::uint32_t>(bucket.size());
+        bucket.push_back(entry);
+        if (locator.leaf != OUTSIDE) {
+            count(locator.leaf, true);
+        }
+    }
+
+    IndexedFighter LooseQuadtree::remove(Locator &locator) {
+        std::vector<IndexedFighter> &bucket = locator.leaf == OUTSIDE ? outside : leaves[locator.leaf];
+        IndexedFighter entry = bucket[locator.slot];
+        bucket[locator.slot] = bucket.back();
+        locators[bucket[locator.slot].fighter].slot = locator.slot;
+        bucket.pop_back();
+        if (locator.leaf != OUTSIDE) {
+            count(locator.leaf, false);
+        }
+        locator.leaf = ABSENT;
+        return entry;
+    }
+
+/**
+ * @brief Updates the fighter counts on the path from a leaf to the root.
+ */
+    void LooseQuadtree::count(std::uint32_t leaf, bool added) {
+        std::size_t x = leaf % (std::size_t{1} << depth);
+        std::size_t y = leaf / (std::size_t{1} << depth);
+        for (std::size_t level = depth + 1; level-- > 0;) {
+            std::uint32_t &nodeCount = counts[level][y * (std::size_t{1} << level) + x];
+            nodeCount = added ? nodeCount + 1 : nodeCount - 1;
+            x /= 2;
+            y /= 2;
+        }
+    }
+
+/**
+ * @brief Follows the new location of a fighter. O(1) while it stays in the loose box of its leaf, O(log n) else.
+ * @throws std::out_of_range If the fighter is not in the tree.
+ */
+    void LooseQuadtree::moved(const Character *fighter) {
+        Locator &locator = locators.at(fighter);
+        if (locator.leaf == ABSENT) {
+            return;
+        }
+        std::vector<IndexedFighter> &bucket = locator.leaf == OUTSIDE ? outside : leaves[locator.leaf];
+        IndexedFighter &entry = bucket[locator.slot];
+        entry.location = fighter->getLocation();
+        if (locator.leaf != OUTSIDE && boxes[depth][locator.leaf].contains(entry.location)) {
+            return;
+        }
+        if (locator.leaf == OUTSIDE && leafOf(entry.location) == OUTSIDE) {
+            return;
+        }
+        insert(remove(locator));
+    }
+
+/**
+ * @brief Removes a fighter that died from the tree, or puts back one that was revived.
+ * @throws std::out_of_range If the fighter is not in the tree.
+ */
+    void LooseQuadtree::aliveChanged(Character *fighter) {
+        Locator &locator = locators.at(fighter);
+        if (fighter->isAlive() && locator.leaf == ABSENT) {
+            insert({fighter->getLocation(), fighter, locator.order});
+        } else if (!fighter->isAlive() && locator.leaf != ABSENT) {
+            remove(locator);
+        }
+    }
+
+/**
+ * @brief Offers the living fighters of the tree to a collector.
+ * Boxes farther than the collector's bound are skipped, boxes at exactly that distance are searched for ties.
+ */
+    template<typename Collector>
+    void LooseQuadtree::collect(const Point &origin, Collector &collector) const {
+        for (const IndexedFighter &entry: outside) {
+            collector.offer(entry.fighter, origin.distance(entry.location), entry.order);
+        }
+        if (!counts.empty()) {
+            search(origin, 0, 0, 0, collector);
+        }
+    }
+
+    template void LooseQuadtree::collect(const Point &origin, NearestCandidate &collector) const;
+
+    template void LooseQuadtree::collect(const Point &origin, NearestHits &collector) const;
+
+    template void LooseQuadtree::collect(const Point &origin, RadiusQuery &collector) const;
+
+    template<typename Collector>
+    void LooseQuadtree::search(const Point &origin, std::size_t level, std::size_t x, std::size_t y,
+                               Collector &collector) const {
+        std::size_t node = y * (std::size_t{1} << level) + x;
+        if (counts[level][node] == 0 || boxes[level][node].distance(origin) > collector.bound()) {
+            return;
+        }
+        if (level == depth) {
+            for (const IndexedFighter &entry: leaves[node]) {
+                collector.offer(entry.fighter, origin.distance(entry.location), entry.order);
+            }
+            return;
+        }
+        std::array<std::pair<double, std::size_t>, 4> children{};
+        for (std::size_t child = 0; child < 4; child++) {
+            std::size_t childX = 2 * x + child % 2;
+            std::size_t childY = 2 * y + child / 2;
+            children[child] = {boxes[level + 1][childY * (std::size_t{2} << level) + childX].distance(origin),
+                               child};
+        }
+        std::sort(children.begin(), children.end());
+        for (const auto &child: children) {
+            search(origin, level + 1, 2 * x + child.second % 2, 2 * y + child.second / 2, collector);
+        }
+    }
+
+/**
+ * @brief Number of living fighters in the tree.
+ */
+    std::size_t LooseQuadtree::size() const {
+        return outside.size() + (counts.empty() ? 0 : counts[0][0]);
+    }
+
+/**
+ * @brief Number of living fighters outside every leaf, scanned by every query.
+ */
+    std::size_t LooseQuadtree::outsideCount() const {
+        return outside.size();
+    }
+
+/**
+ * @brief Whether so many fighters walked out of the tree that it should be rebuilt around them.
+ */
+    bool LooseQuadtree::degraded() const {
+        return outside.size() > std::max<std::size_t>(16, size() / 8);
+    }
+
+/**
+ * @brief Bytes held by the tree, the hash table nodes are estimated.
+ */
+    std::size_t LooseQuadtree::bytes() const {
+        std::size_t total = sizeof(LooseQuadtree) + outside.capacity() * sizeof(IndexedFighter);
+        for (std::size_t level = 0; level < boxes.size(); level++) {
+            total += boxes[level].capacity() * sizeof(Box) + counts[level].capacity() * sizeof(std::uint32_t);
+        }
+        for (const auto &leaf: leaves) {
+            total += sizeof(leaf) + leaf.capacity() * sizeof(IndexedFighter);
+        }
+        total += locators.bucket_count() * sizeof(void *) +
+                 locators.size() * (sizeof(std::pair<const Character *const, Locator>) + sizeof(void *));
+        return total;
+    }
+
+}
@@ -0,0 +1,90 @@
+/**
+ * @file LooseQuadtree.hpp
+ * @brief A loose quadtree of moving fighters for nearest living fighter queries.
+ * Fighters live in the leaves of a complete quadtree. A leaf keeps a fighter while it stays within the leaf's
+ * cell grown by half a cell on every side, so most moves only update the stored location. Moves that leave the
+ * loose bounds and deaths update the tree in O(log n).
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_LOOSEQUADTREE_HPP
+#define COWBOY_VS_NINJA_A_LOOSEQUADTREE_HPP
+
+#include "KdTree.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ariel {
+
+    class LooseQuadtree {
+    private:
+        struct Box {
+            double minX;
+            double minY;
+            double maxX;
+            double maxY;
+
+            bool contains(const Point &location) const;
+
+            double distance(const Point &origin) const;
+        };
+
+        struct Locator {
+            std::uint32_t leaf;
+            std::uint32_t slot;
+            std::uint32_t order;
+        };
+
+        // Leaf value of fighters outside every leaf, they are kept in outside and always scanned.
+        static const std::uint32_t OUTSIDE = UINT32_MAX;
+        // Leaf value of dead fighters, they are not in the tree.
+        static const std::uint32_t ABSENT = UINT32_MAX - 1;
+
+        std::size_t depth = 0;
+        double originX = 0;
+        double originY = 0;
+        double cellSize = 1;
+        // Per level, node (x, y) of level l at index y * 2^l + x.
+        std::vector<std::vector<Box>> boxes;
+        std::vector<std::vector<std::uint32_t>> counts;
+        std::vector<std::vector<IndexedFighter>> leaves;
+        std::vector<IndexedFighter> outside;
+        std::unordered_map<const Character *, Locator> locators;
+
+        std::uint32_t leafOf(const Point &location) const;
+
+        void insert(const IndexedFighter &entry);
+
+        IndexedFighter remove(Locator &locator);
+
+        void count(std::uint32_t leaf, bool added);
+
+        template<typename Collector>
+        void search(const Point &origin, std::size_t level, std::size_t x, std::size_t y,
+                    Collector &collector) const;
+
+    public:
+        void build(const std::vector<IndexedFighter> &fighters);
+
+        void moved(const Character *fighter);
+
+        void aliveChanged(Character *fighter);
+
+        // Collector is NearestCandidate, NearestHits or RadiusQuery.
+        template<typename Collector>
+        void collect(const Point &origin, Collector &collector) const;
+
+        std::size_t size() const;
+
+        std::size_t outsideCount() const;
+
+        bool degraded() const;
+
+        std::size_t bytes() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_LOOSEQUADTREE_HPP
@@ -0,0 +1,106 @@
+/**
+ * @file MemoryBudget.cpp
+ * @brief Implements the lock free byte budget and its reservations.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "MemoryBudget.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace ariel {
+
+/**
+ * @brief Constructs an empty budget.
+ * @param ceiling Maximum number of bytes reserved at the same time.
+ */
+    MemoryBudget::MemoryBudget(std::size_t ceiling) : ceiling(ceiling), used(0), refused(0) {}
+
+/**
+ * @brief Reserves bytes if they fit under the ceiling. Lock free, safe to call from any thread.
+ * @param bytes The bytes to reserve.
+ * @return true if the bytes were reserved, false if they were refused.
+ */
+    bool MemoryBudget::tryReserve(std::size_t bytes) {
+        std::size_t current = used.load(std::memory_order_relaxed);
+        do {
+            if (bytes > ceiling - current) {
+                refused.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!used.compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+        return true;
+    }
+
+/**
+ * @brief Gives back bytes reserved by tryReserve.
+ */
+    void MemoryBudget::release(std::size_t bytes) {
+        used.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+/**
+ * @brief The ceiling of the budget in bytes.
+ */
+    std::size_t MemoryBudget::getCeiling() const {
+        return ceiling;
+    }
+
+/**
+ * @brief Bytes reserved at the moment.
+ */
+    std::size_t MemoryBudget::inUse() const {
+        return used.load(std::memory_order_relaxed);
+    }
+
+/**
+ * @brief Number of refused reservations since construction.
+ */
+    std::size_t MemoryBudget::refusals() const {
+        return refused.load(std::memory_order_relaxed);
+    }
+
+/**
+ * @brief Constructs a reservation of nothing.
+ */
+    MemoryReservation::MemoryReservation() : budget(nullptr), bytes(0) {}
+
+/**
+ * @brief Reserves bytes from a budget until the reservation is destroyed.
+ * @throws std::runtime_error If the bytes do not fit under the ceiling of the budget.
+ */
+    MemoryReservation::MemoryReservation(MemoryBudget &budget, std::size_t bytes) : budget(&budget), bytes(bytes) {
+        if (!budget.tryReserve(bytes)) {
+            throw std::runtime_error("Error: Memory budget exceeded.");
+        }
+    }
+
+    MemoryReservation::~MemoryReservation() {
+        if (budget != nullptr) {
+            budget->release(bytes);
+        }
+    }
+
+/**
+ * @brief Number of bytes held by the reservation.
+ */
+    std::size_t MemoryReservation::getBytes() const {
+        return bytes;
+    }
+
+    MemoryReservation::MemoryReservation(MemoryReservation &&other) noexcept
+            : budget(std::exchange(other.budget, nullptr)), bytes(std::exchange(other.bytes, 0)) {}
+
+    MemoryReservation &MemoryReservation::operator=(MemoryReservation &&other) noexcept {
+        if (this != &other) {
+            if (budget != nullptr) {
+                budget->release(bytes);
+            }
+            budget = std::exchange(other.budget, nullptr);
+            bytes = std::exchange(other.bytes, 0);
+        }
+        return *this;
+    }
+
+}
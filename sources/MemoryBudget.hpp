@@ -0,0 +1,71 @@
+/**
+ * @file MemoryBudget.hpp
+ * @brief A byte ceiling shared by concurrent battles. A battle reserves its bytes when it starts and releases them
+ * when it is destroyed, a battle that does not fit under the ceiling is refused.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_MEMORYBUDGET_HPP
+#define COWBOY_VS_NINJA_A_MEMORYBUDGET_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace ariel {
+
+    class MemoryBudget {
+    private:
+        std::size_t ceiling;
+        std::atomic<std::size_t> used;
+        std::atomic<std::size_t> refused;
+
+    public:
+        explicit MemoryBudget(std::size_t ceiling);
+
+        bool tryReserve(std::size_t bytes);
+
+        void release(std::size_t bytes);
+
+        std::size_t getCeiling() const;
+
+        std::size_t inUse() const;
+
+        std::size_t refusals() const;
+
+        MemoryBudget(const MemoryBudget &) = delete;
+
+        MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+        MemoryBudget(MemoryBudget &&) = delete;
+
+        MemoryBudget &operator=(MemoryBudget &&) = delete;
+    };
+
+    // Owns bytes reserved from a budget and gives them back when destroyed.
+    class MemoryReservation {
+    private:
+        MemoryBudget *budget;
+        std::size_t bytes;
+
+    public:
+        MemoryReservation();
+
+        MemoryReservation(MemoryBudget &budget, std::size_t bytes);
+
+        ~MemoryReservation();
+
+        std::size_t getBytes() const;
+
+        MemoryReservation(const MemoryReservation &) = delete;
+
+        MemoryReservation &operator=(const MemoryReservation &) = delete;
+
+        MemoryReservation(MemoryReservation &&other) noexcept;
+
+        MemoryReservation &operator=(MemoryReservation &&other) noexcept;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_MEMORYBUDGET_HPP
@@ -0,0 +1,99 @@
+/**
+ * @file NamePool.cpp
+ * @brief Thread safe name interning, lookups of known names take a shared lock and never allocate.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "NamePool.hpp"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace ariel {
+
+    namespace {
+        struct Pool {
+            std::shared_mutex lock;
+            // deque elements never move, so the views used as keys stay valid
+            std::deque<std::string> names;
+            std::unordered_map<std::string_view, NameId> ids;
+        };
+
+        /**
+         * @brief The pool, constructed on first use so characters can be created during static initialization.
+         */
+        Pool &pool() {
+            static Pool instance;
+            return instance;
+        }
+    }
+
+/**
+ * @brief Returns the handle of a name, adding the name to the pool the first time it is seen.
+ * @param name The name.
+ * @return The handle of the name.
+ * @throws std::length_error If the pool is full.
+ */
+    NameId NamePool::intern(std::string_view name) {
+        Pool &names = pool();
+        {
+            std::shared_lock<std::shared_mutex> guard(names.lock);
+            auto found = names.ids.find(name);
+            if (found != names.ids.end()) {
+                return found->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> guard(names.lock);
+        auto found = names.ids.find(name);
+        if (found != names.ids.end()) {
+            return found->second;
+        }
+        if (names.names.size() >= MAX_NAMES) {
+            throw std::length_error("Error: Too many distinct names.");
+        }
+        auto id = static_cast<NameId>(names.names.size());
+        names.names.emplace_back(name);
+        names.ids.emplace(names.names.back(), id);
+        return id;
+    }
+
+/**
+ * @brief The text of an interned name.
+ * @param name The handle of the name.
+ * @return A reference that stays valid for the whole run.
+ * @throws std::out_of_range If the handle was not returned by intern.
+ */
+    const std::string &NamePool::text(NameId name) {
+        Pool &names = pool();
+        std::shared_lock<std::shared_mutex> guard(names.lock);
+        return names.names.at(name);
+    }
+
+/**
+ * @brief Bytes held by one name: its string object and, for names too long for the small string buffer, the heap
+ * buffer. The hash table node of the name is not counted.
+ * @param name The handle of the name.
+ * @throws std::out_of_range If the handle was not returned by intern.
+ */
+    std::size_t NamePool::footprint(NameId name) {
+        Pool &names = pool();
+        std::shared_lock<std::shared_mutex> guard(names.lock);
+        const std::string &text = names.names.at(name);
+        const auto *object = reinterpret_cast<const char *>(&text);
+        bool inline_ = text.data() >= object && text.data() < object + sizeof(std::string);
+        return sizeof(std::string) + (inline_ ? 0 : text.capacity() + 1);
+    }
+
+/**
+ * @brief Number of distinct names in the pool.
+ */
+    std::size_t NamePool::size() {
+        Pool &names = pool();
+        std::shared_lock<std::shared_mutex> guard(names.lock);
+        return names.names.size();
+    }
+
+}
@@ -0,0 +1,37 @@
+/**
+ * @file NamePool.hpp
+ * @brief Interning pool for fighter names. A Character keeps a 32 bit handle and the text is stored once per
+ * distinct name, so creating a character with a known name allocates nothing.
+ * Names are never removed, the pool is meant for the small set of names rosters are built from.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_NAMEPOOL_HPP
+#define COWBOY_VS_NINJA_A_NAMEPOOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ariel {
+
+    using NameId = std::uint32_t;
+
+    class NamePool {
+    public:
+        // Character keeps the handle in 30 bits.
+        static constexpr std::size_t MAX_NAMES = std::size_t{1} << 30;
+
+        static NameId intern(std::string_view name);
+
+        static const std::string &text(NameId name);
+
+        static std::size_t size();
+
+        static std::size_t footprint(NameId name);
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_NAMEPOOL_HPP
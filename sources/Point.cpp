@@ -14,37 +14,23 @@ namespace ariel {
  * @param y The y coordinate.
  * @throws std::invalid_argument if the coordinates are NaN, infinite, or out of bounds.
  */
-    Point::Point(double coordinate_x, double coordinate_y) {
-        if (coordinate_x > std::numeric_limits<double>::max() || coordinate_y < std::numeric_limits<double>::lowest()) {
+    template<typename T>
+    BasicPoint<T>::BasicPoint(T coordinate_x, T coordinate_y) {
+        if (coordinate_x > std::numeric_limits<T>::max() || coordinate_y < std::numeric_limits<T>::lowest()) {
             throw std::out_of_range("Invalid coordinates: Out of bounds.");
         }
         this->coordinate_x = coordinate_x;
         this->coordinate_y = coordinate_y;
     }
 
-/**
-* @brief Returns the x coordinate of this position.
-* @return The x coordinate of this position.
-*/
-    double Point::getX() const {
-        return this->coordinate_x;
-    }
-
-/**
-* @brief Returns the y coordinate of this position.
-* @return The y coordinate of this position.
-*/
-    double Point::getY() const {
-        return this->coordinate_y;
-    }
-
 /**
  * @brief Set the x-coordinate of the point.
  * @param newX The new value for the x-coordinate.
  * @throw std::out_of_range if newX is out of bounds.
  */
-    void Point::setX(double newX) {
-        if (std::abs(newX) > DBL_MAX) {
+    template<typename T>
+    void BasicPoint<T>::setX(T newX) {
+        if (std::abs(newX) > std::numeric_limits<T>::max()) {
             throw std::out_of_range("Invalid coordinates: Out of bounds.");
         }
         this->coordinate_x = newX;
@@ -55,8 +41,9 @@ namespace ariel {
  * @param newY The new value for the y-coordinate.
  * @throw std::out_of_range if newY is out of bounds.
  */
-    void Point::setY(double newY) {
-        if (std::abs(newY) > DBL_MAX) {
+    template<typename T>
+    void BasicPoint<T>::setY(T newY) {
+        if (std::abs(newY) > std::numeric_limits<T>::max()) {
             throw std::out_of_range("Invalid coordinates: Out of bounds.");
         }
         this->coordinate_y = newY;
@@ -67,16 +54,18 @@ namespace ariel {
 * @param other The other position.
 * @return The distance between this position and the other position.
 */
-    double Point::distance(const ariel::Point &other) const {
-        double dx = this->coordinate_x - other.coordinate_x;
-        double dy = this->coordinate_y - other.coordinate_y;
+    template<typename T>
+    T BasicPoint<T>::distance(const BasicPoint<T> &other) const {
+        T dx = this->coordinate_x - other.coordinate_x;
+        T dy = this->coordinate_y - other.coordinate_y;
         return std::sqrt(dx * dx + dy * dy);
     }
 
 /**
 * @brief Prints this position to standard output in the format [x, y].
 */
-    std::string Point::print() const {
+    template<typename T>
+    std::string BasicPoint<T>::print() const {
         return "[" + std::to_string(this->coordinate_x) + "," + std::to_string(this->coordinate_y) + "]";
     }
 
@@ -87,24 +76,29 @@ namespace ariel {
 * @param distance The maximum distance from the source position to the returned position.
 * @return The closest point to the destination point that is at most the given distance from the source point.
 */
-    Point Point::moveTowards(const ariel::Point &source, const ariel::Point &dest, double distance) {
+    template<typename T>
+    BasicPoint<T> BasicPoint<T>::moveTowards(const BasicPoint<T> &source, const BasicPoint<T> &dest, T distance) {
         if (distance < 0) {
             throw std::invalid_argument("maxDist cannot be negative");
         }
         if (source.getX() == dest.getX() && source.getY() == dest.getY()) {
             throw std::invalid_argument("source and dest cannot be the same position");
         }
-        double dist = source.distance(dest);
+        T dist = source.distance(dest);
         if (dist <= distance) {
             return dest;
         }
-        double dx = dest.coordinate_x - source.coordinate_x;
-        double dy = dest.coordinate_y - source.coordinate_y;
+        T dx = dest.coordinate_x - source.coordinate_x;
+        T dy = dest.coordinate_y - source.coordinate_y;
 
-        double newX = source.coordinate_x + distance * dx / dist;
-        double newY = source.coordinate_y + distance * dy / dist;
+        T newX = source.coordinate_x + distance * dx / dist;
+        T newY = source.coordinate_y + distance * dy / dist;
 
-        return Point(newX, newY);
+        return BasicPoint<T>(newX, newY);
     }
 
+    template class BasicPoint<double>;
+
+    template class BasicPoint<float>;
+
 }
\ No newline at end of file
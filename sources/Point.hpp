@@ -1,7 +1,9 @@
 /**
  * @file Point.hpp
  * @brief Header file for the Point class - A class that will help us save a position on the game board.
- * The position is given as two double coordinates that keep the position of the unit along the x and y axes accordingly.
+ * The position is given as two coordinates that keep the position of the unit along the x and y axes accordingly.
+ * BasicPoint is a template over the coordinate type, Point (double) is the board type. PointF (float) is a compact
+ * value type for code that keeps its own coordinates, fighters and the battle rules always use Point.
  * @author Tomer Gozlan
  * @date 11/05/2023 
  */
@@ -15,30 +17,60 @@
 
 namespace ariel {
 
-    class Point {
+    template<typename T>
+    class BasicPoint {
+
+        static_assert(std::is_floating_point<T>::value, "BasicPoint coordinates must be a floating point type.");
 
     private:
-        double coordinate_x;
-        double coordinate_y;
+        T coordinate_x;
+        T coordinate_y;
     public:
 
-        Point(double coordinate_x, double coordinate_y);
+        BasicPoint(T coordinate_x, T coordinate_y);
+
+        template<typename U>
+        explicit BasicPoint(const BasicPoint<U> &other) : BasicPoint(static_cast<T>(other.getX()),
+                                                                     static_cast<T>(other.getY())) {}
+
+        // Inline, they are read in every distance loop of the engine.
+        T getX() const {
+            return coordinate_x;
+        }
+
+        T getY() const {
+            return coordinate_y;
+        }
 
-        double getX() const;
+        void setX(T newX);
 
-        double getY() const;
+        void setY(T newY);
 
-        void setX(double newX);
+        T distance(const BasicPoint &other) const;
 
-        void setY(double newY);
+        // Alpha max plus beta min estimate of distance(), without a square root. Inline like the getters, it is
+        // meant for ranking loops. Off by at most APPROXIMATE_DISTANCE_ERROR of the exact distance, either way.
+        T approximateDistance(const BasicPoint &other) const {
+            T dx = std::abs(coordinate_x - other.coordinate_x);
+            T dy = std::abs(coordinate_y - other.coordinate_y);
+            return static_cast<T>(0.96043387) * std::max(dx, dy) + static_cast<T>(0.39782473) * std::min(dx, dy);
+        }
 
-        double distance(const Point &other) const;
+        static constexpr double APPROXIMATE_DISTANCE_ERROR = 0.0396;
 
         std::string print() const;
 
-        static Point moveTowards(const Point &source, const Point &dest, double distance);
+        static BasicPoint moveTowards(const BasicPoint &source, const BasicPoint &dest, T distance);
 
     };
+
+    using Point = BasicPoint<double>;
+
+    using PointF = BasicPoint<float>;
+
+    extern template class BasicPoint<double>;
+
+    extern template class BasicPoint<float>;
 }
 
-#endif //COWBOY_VS_NINJA_A_POINT_HPP
\ No newline at end of file
+#endif //COWBOY_VS_NINJA_A_POINT_HPP
@@ -0,0 +1,164 @@
+/**
+ * @file Profiler.cpp
+ * @brief Lock free per-phase histograms and their table / JSON dumps.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "Profiler.hpp"
+#include <chrono>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace ariel {
+
+    std::array<PhaseProfiler::Histogram, static_cast<std::size_t>(Phase::Count)> PhaseProfiler::histograms;
+
+    namespace {
+        const std::array<const char *, static_cast<std::size_t>(Phase::Count)> PHASE_NAMES = {
+                "leader_election", "victim_search", "cowboy_phase", "ninja_phase", "liveness_check",
+                "enemy_leader_reassignment"
+        };
+
+        /**
+         * @brief Histogram bucket of a sample, the bit width of the tick count.
+         */
+        std::size_t bucketOf(std::uint64_t ticks) {
+            std::size_t bucket = 0;
+            while (ticks != 0 && bucket < PhaseProfiler::BUCKETS - 1) {
+                ticks >>= 1U;
+                bucket++;
+            }
+            return bucket;
+        }
+    }
+
+/**
+ * @brief Reads the tick counter.
+ * @return Cycles from rdtsc on x86, steady_clock nanoseconds otherwise.
+ */
+    std::uint64_t PhaseProfiler::now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+/**
+ * @brief Adds one sample to the histogram of a phase. Safe to call from several threads.
+ * @param phase The measured phase.
+ * @param ticks The duration of the sample.
+ */
+    void PhaseProfiler::record(Phase phase, std::uint64_t ticks) {
+        Histogram &histogram = histograms.at(static_cast<std::size_t>(phase));
+        histogram.samples.fetch_add(1, std::memory_order_relaxed);
+        histogram.total.fetch_add(ticks, std::memory_order_relaxed);
+        histogram.buckets.at(bucketOf(ticks)).fetch_add(1, std::memory_order_relaxed);
+    }
+
+/**
+ * @brief Number of samples recorded for a phase.
+ */
+    std::uint64_t PhaseProfiler::samples(Phase phase) {
+        return histograms.at(static_cast<std::size_t>(phase)).samples.load(std::memory_order_relaxed);
+    }
+
+/**
+ * @brief Sum of the ticks recorded for a phase.
+ */
+    std::uint64_t PhaseProfiler::totalTicks(Phase phase) {
+        return histograms.at(static_cast<std::size_t>(phase)).total.load(std::memory_order_relaxed);
+    }
+
+/**
+ * @brief Upper bound of the histogram bucket holding the given percentile.
+ * @param phase The measured phase.
+ * @param fraction The percentile as a fraction, for example 0.99.
+ * @return An upper bound (power of two) on the percentile, 0 if no samples were recorded.
+ */
+    std::uint64_t PhaseProfiler::percentile(Phase phase, double fraction) {
+        const Histogram &histogram = histograms.at(static_cast<std::size_t>(phase));
+        std::uint64_t count = histogram.samples.load(std::memory_order_relaxed);
+        if (count == 0) {
+            return 0;
+        }
+        auto target = static_cast<std::uint64_t>(fraction * static_cast<double>(count));
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < BUCKETS; bucket++) {
+            seen += histogram.buckets.at(bucket).load(std::memory_order_relaxed);
+            if (seen > target || seen == count) {
+                return bucket == 0 ? 0 : (std::uint64_t{1} << bucket) - 1;
+            }
+        }
+        return UINT64_MAX;
+    }
+
+/**
+ * @brief Clears all histograms.
+ */
+    void PhaseProfiler::reset() {
+        for (Histogram &histogram: histograms) {
+            histogram.samples = 0;
+            histogram.total = 0;
+            for (std::atomic<std::uint64_t> &bucket: histogram.buckets) {
+                bucket = 0;
+            }
+        }
+    }
+
+/**
+ * @brief Human readable table: samples, total, mean, p50 and p99 ticks per phase.
+ */
+    std::string PhaseProfiler::table() {
+        std::ostringstream out;
+        out << "phase                      samples        total_ticks   mean    p50<=    p99<=" << std::endl;
+        for (std::size_t index = 0; index < PHASE_NAMES.size(); index++) {
+            auto phase = static_cast<Phase>(index);
+            std::uint64_t count = samples(phase);
+            std::uint64_t total = totalTicks(phase);
+            out.width(26);
+            out << std::left << PHASE_NAMES.at(index) << std::right;
+            out.width(8);
+            out << count << ' ';
+            out.width(18);
+            out << total << ' ';
+            out.width(6);
+            out << (count == 0 ? 0 : total / count) << ' ';
+            out.width(8);
+            out << percentile(phase, 0.5) << ' ';
+            out.width(8);
+            out << percentile(phase, 0.99) << std::endl;
+        }
+        return out.str();
+    }
+
+/**
+ * @brief JSON dump: for every phase the samples, total ticks and the non empty histogram buckets.
+ */
+    std::string PhaseProfiler::json() {
+        std::ostringstream out;
+        out << "{";
+        for (std::size_t index = 0; index < PHASE_NAMES.size(); index++) {
+            const Histogram &histogram = histograms.at(index);
+            out << (index == 0 ? "" : ",") << "\"" << PHASE_NAMES.at(index) << "\":{\"samples\":"
+                << histogram.samples.load() << ",\"total_ticks\":" << histogram.total.load() << ",\"buckets\":{";
+            bool first = true;
+            for (std::size_t bucket = 0; bucket < BUCKETS; bucket++) {
+                std::uint64_t value = histogram.buckets.at(bucket).load();
+                if (value != 0) {
+                    out << (first ? "" : ",") << "\"" << bucket << "\":" << value;
+                    first = false;
+                }
+            }
+            out << "}}";
+        }
+        out << "}";
+        return out.str();
+    }
+
+}
@@ -0,0 +1,95 @@
+/**
+ * @file Profiler.hpp
+ * @brief Optional per-phase timing of Team::attack.
+ * Build with -DCOWBOY_VS_NINJA_PROFILE (make PROFILE=1) to record, otherwise PROFILE_PHASE expands to nothing.
+ * Ticks are rdtsc cycles on x86-64 and steady_clock nanoseconds elsewhere.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_PROFILER_HPP
+#define COWBOY_VS_NINJA_A_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace ariel {
+
+    enum class Phase {
+        LeaderElection,
+        VictimSearch,
+        CowboyPhase,
+        NinjaPhase,
+        LivenessCheck,
+        EnemyLeaderReassignment,
+        Count
+    };
+
+    class PhaseProfiler {
+    public:
+        // Bucket i counts the samples with 2^(i-1) <= ticks < 2^i, bucket 0 counts zero tick samples.
+        static const std::size_t BUCKETS = 64;
+
+    private:
+        struct Histogram {
+            std::atomic<std::uint64_t> samples{0};
+            std::atomic<std::uint64_t> total{0};
+            std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+        };
+
+        static std::array<Histogram, static_cast<std::size_t>(Phase::Count)> histograms;
+
+    public:
+        static std::uint64_t now();
+
+        static void record(Phase phase, std::uint64_t ticks);
+
+        static std::uint64_t samples(Phase phase);
+
+        static std::uint64_t totalTicks(Phase phase);
+
+        static std::uint64_t percentile(Phase phase, double fraction);
+
+        static void reset();
+
+        static std::string table();
+
+        static std::string json();
+    };
+
+    class ScopedPhaseTimer {
+    private:
+        Phase phase;
+        std::uint64_t start;
+
+    public:
+        explicit ScopedPhaseTimer(Phase phase) : phase(phase), start(PhaseProfiler::now()) {}
+
+        ~ScopedPhaseTimer() {
+            PhaseProfiler::record(phase, PhaseProfiler::now() - start);
+        }
+
+        ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+
+        ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+        ScopedPhaseTimer(ScopedPhaseTimer &&) = delete;
+
+        ScopedPhaseTimer &operator=(ScopedPhaseTimer &&) = delete;
+    };
+
+}
+
+#define COWBOY_VS_NINJA_CONCAT_INNER(first, second) first##second
+#define COWBOY_VS_NINJA_CONCAT(first, second) COWBOY_VS_NINJA_CONCAT_INNER(first, second)
+
+#ifdef COWBOY_VS_NINJA_PROFILE
+#define PROFILE_PHASE(phase) \
+    const ariel::ScopedPhaseTimer COWBOY_VS_NINJA_CONCAT(phaseTimer, __LINE__)(ariel::Phase::phase)
+#else
+#define PROFILE_PHASE(phase) static_cast<void>(0)
+#endif
+
+#endif //COWBOY_VS_NINJA_A_PROFILER_HPP
@@ -0,0 +1,362 @@
+/**
+ * @file Protocol.cpp
+ * @brief Encoding and decoding of the binary frames, every malformed payload is rejected with an exception.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "Protocol.hpp"
+#include <bit>
+
+namespace ariel {
+
+    namespace {
+
+        /**
+         * @brief Appends little endian values to a frame.
+         */
+        class Writer {
+        private:
+            std::vector<std::uint8_t> bytes;
+
+        public:
+            explicit Writer(std::uint32_t magic) : bytes(Protocol::HEADER_SIZE, 0) {
+                for (std::size_t i = 0; i < 4; i++) {
+                    bytes[i] = static_cast<std::uint8_t>(magic >> (8 * i));
+                }
+            }
+
+            void u8(std::uint8_t value) {
+                bytes.push_back(value);
+            }
+
+            void u32(std::uint32_t value) {
+                for (std::size_t i = 0; i < 4; i++) {
+                    bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+                }
+            }
+
+            void i32(int value) {
+                u32(static_cast<std::uint32_t>(value));
+            }
+
+            void f64(double value) {
+                auto raw = std::bit_cast<std::uint64_t>(value);
+                for (std::size_t i = 0; i < 8; i++) {
+                    bytes.push_back(static_cast<std::uint8_t>(raw >> (8 * i)));
+                }
+            }
+
+            std::vector<std::uint8_t> finish() {
+                auto length = static_cast<std::uint32_t>(bytes.size() - Protocol::HEADER_SIZE);
+                for (std::size_t i = 0; i < 4; i++) {
+                    bytes[4 + i] = static_cast<std::uint8_t>(length >> (8 * i));
+                }
+                return std::move(bytes);
+            }
+        };
+
+        /**
+         * @brief Reads little endian values from a payload, throwing when it is too short.
+         */
+        class Reader {
+        private:
+            const std::vector<std::uint8_t> &bytes;
+            std::size_t position;
+
+            const std::uint8_t *take(std::size_t count) {
+                if (bytes.size() - position < count) {
+                    throw std::runtime_error("Error: Truncated payload.");
+                }
+                const std::uint8_t *start = bytes.data() + position;
+                position += count;
+                return start;
+            }
+
+            std::uint64_t little(std::size_t count) {
+                const std::uint8_t *start = take(count);
+                std::uint64_t value = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    value |= std::uint64_t{start[i]} << (8 * i);
+                }
+                return value;
+            }
+
+        public:
+            explicit Reader(const std::vector<std::uint8_t> &bytes) : bytes(bytes), position(0) {}
+
+            std::uint8_t u8() {
+                return *take(1);
+            }
+
+            std::uint32_t u32() {
+                return static_cast<std::uint32_t>(little(4));
+            }
+
+            int i32() {
+                return static_cast<int>(u32());
+            }
+
+            double f64() {
+                return std::bit_cast<double>(little(8));
+            }
+
+            void finish() const {
+                if (position != bytes.size()) {
+                    throw std::runtime_error("Error: Trailing bytes in payload.");
+                }
+            }
+        };
+
+        void writeTeam(Writer &out, const TeamSpec &team) {
+            if (team.fighters.size() > UINT8_MAX) {
+                throw std::invalid_argument("Error: Too many fighters for the protocol.");
+            }
+            out.u8(static_cast<std::uint8_t>(team.fighters.size()));
+            out.u8(team.leader);
+            for (const FighterSpec &fighter: team.fighters) {
+                out.u8(static_cast<std::uint8_t>(fighter.kind));
+                out.f64(fighter.x);
+                out.f64(fighter.y);
+                out.i32(fighter.hitPoints);
+            }
+        }
+
+        TeamSpec readTeam(Reader &in) {
+            TeamSpec team;
+            std::size_t count = in.u8();
+            team.leader = in.u8();
+            for (std::size_t i = 0; i < count; i++) {
+                FighterSpec fighter;
+                std::uint8_t kind = in.u8();
+                // Only the four kinds with a constructor of their own can be sent.
+                if (kind > static_cast<std::uint8_t>(FighterKind::OldNinja)) {
+                    throw std::runtime_error("Error: Unknown fighter kind.");
+                }
+                fighter.kind = static_cast<FighterKind>(kind);
+                fighter.x = in.f64();
+                fighter.y = in.f64();
+                fighter.hitPoints = in.i32();
+                team.fighters.push_back(std::move(fighter));
+            }
+            return team;
+        }
+
+        /**
+         * @brief Constructs one fighter of a description, with new or in an arena, under the name of its kind.
+         */
+        template<typename Fighter>
+        Character *construct(const FighterSpec &spec, FighterArena *arena, const char *kindName) {
+            Point location(spec.x, spec.y);
+            if (arena == nullptr) {
+                return new Fighter(kindName, location);
+            }
+            return new(arena->allocate(sizeof(Fighter))) Fighter(kindName, location);
+        }
+
+        void discard(Character *fighter, FighterArena *arena) {
+            if (arena == nullptr) {
+                delete fighter;
+            } else {
+                fighter->~Character();
+            }
+        }
+
+        Character *buildFighter(const FighterSpec &spec, FighterArena *arena) {
+            Character *fighter = nullptr;
+            switch (spec.kind) {
+                case FighterKind::Cowboy:
+                    fighter = construct<Cowboy>(spec, arena, "Cowboy");
+                    break;
+                case FighterKind::YoungNinja:
+                    fighter = construct<YoungNinja>(spec, arena, "YoungNinja");
+                    break;
+                case FighterKind::TrainedNinja:
+                    fighter = construct<TrainedNinja>(spec, arena, "TrainedNinja");
+                    break;
+                case FighterKind::OldNinja:
+                    fighter = construct<OldNinja>(spec, arena, "OldNinja");
+                    break;
+                default:
+                    // Ninja has a custom speed that the description does not carry.
+                    throw std::runtime_error("Error: Unknown fighter kind.");
+            }
+            if (spec.hitPoints != 0) {
+                try {
+                    fighter->setHitPoints(spec.hitPoints);
+                } catch (...) {
+                    discard(fighter, arena);
+                    throw;
+                }
+            }
+            return fighter;
+        }
+
+        Team assemble(const TeamSpec &spec, FighterArena *arena) {
+            if (spec.fighters.empty() || spec.leader >= spec.fighters.size()) {
+                throw std::invalid_argument("Error: Invalid team description.");
+            }
+            Character *leader = buildFighter(spec.fighters[spec.leader], arena);
+            Team team = arena == nullptr ? Team(leader) : Team(leader, *arena);
+            for (std::size_t i = 0; i < spec.fighters.size(); i++) {
+                if (i != spec.leader) {
+                    Character *fighter = buildFighter(spec.fighters[i], arena);
+                    try {
+                        team.add(fighter);
+                    } catch (...) {
+                        discard(fighter, arena);
+                        throw;
+                    }
+                }
+            }
+            return team;
+        }
+    }
+
+/**
+ * @brief Builds a team from its description, with the usual constructor and add() validation.
+ * The fighters are named after their kind, the description has no names.
+ * @param spec The description of the team.
+ * @return The team.
+ * @throws std::invalid_argument If the team is empty or the leader index is out of range.
+ * @throws std::runtime_error If a fighter is not one of the four kinds that can be sent.
+ * @throws Any exception of the Character and Team constructors.
+ */
+    Team Protocol::buildTeam(const TeamSpec &spec) {
+        return assemble(spec, nullptr);
+    }
+
+/**
+ * @brief Builds a team from its description in a fighter arena, without a heap allocation per fighter.
+ * @param spec The description of the team.
+ * @param arena Reset with room for at least arenaBytes(spec) more bytes, it must outlive the team.
+ * @return The team, its fighters are destroyed in place.
+ * @throws The exceptions of buildTeam(const TeamSpec &), std::length_error if the arena is too small.
+ */
+    Team Protocol::buildTeam(const TeamSpec &spec, FighterArena &arena) {
+        return assemble(spec, &arena);
+    }
+
+/**
+ * @brief The room buildTeam(spec, arena) takes in the arena, every fighter in a slot of the largest kind.
+ */
+    std::size_t Protocol::arenaBytes(const TeamSpec &spec) {
+        return spec.fighters.size() * Team::FIGHTER_SLOT;
+    }
+
+/**
+ * @brief Encodes a batch of scenarios as a request frame.
+ * @throws std::invalid_argument If there are more than MAX_SCENARIOS scenarios.
+ */
+    std::vector<std::uint8_t> Protocol::encodeRequest(const std::vector<Scenario> &scenarios) {
+        if (scenarios.size() > MAX_SCENARIOS) {
+            throw std::invalid_argument("Error: Too many scenarios in one request.");
+        }
+        Writer out(REQUEST_MAGIC);
+        out.u32(static_cast<std::uint32_t>(scenarios.size()));
+        for (const Scenario &scenario: scenarios) {
+            out.i32(scenario.options.maxRounds);
+            out.u8(static_cast<std::uint8_t>(scenario.movement));
+            writeTeam(out, scenario.teamA);
+            writeTeam(out, scenario.teamB);
+        }
+        return out.finish();
+    }
+
+/**
+ * @brief Decodes the payload of a request frame (without its header).
+ * @throws std::runtime_error If the payload is malformed or holds more than MAX_SCENARIOS scenarios.
+ */
+    std::vector<Scenario> Protocol::decodeRequest(const std::vector<std::uint8_t> &payload) {
+        Reader in(payload);
+        std::uint32_t count = in.u32();
+        if (count > MAX_SCENARIOS) {
+            throw std::runtime_error("Error: Too many scenarios in one request.");
+        }
+        std::vector<Scenario> scenarios;
+        for (std::uint32_t i = 0; i < count; i++) {
+            Scenario scenario;
+            scenario.options.maxRounds = in.i32();
+            std::uint8_t movement = in.u8();
+            if (movement > static_cast<std::uint8_t>(Movement::Deterministic)) {
+                throw std::runtime_error("Error: Unknown movement mode.");
+            }
+            scenario.movement = static_cast<Movement>(movement);
+            scenario.teamA = readTeam(in);
+            scenario.teamB = readTeam(in);
+            scenarios.push_back(std::move(scenario));
+        }
+        in.finish();
+        return scenarios;
+    }
+
+/**
+ * @brief Encodes battle results as a response frame.
+ */
+    std::vector<std::uint8_t> Protocol::encodeResponse(const std::vector<BattleResult> &results) {
+        Writer out(RESPONSE_MAGIC);
+        out.u32(static_cast<std::uint32_t>(results.size()));
+        for (const BattleResult &result: results) {
+            out.u8(static_cast<std::uint8_t>(result.winner));
+            out.i32(result.rounds);
+            out.i32(result.survivorsA);
+            out.i32(result.survivorsB);
+            out.i32(result.damageDealtA);
+            out.i32(result.damageDealtB);
+            out.i32(result.hitPointsA);
+            out.i32(result.hitPointsB);
+        }
+        return out.finish();
+    }
+
+/**
+ * @brief Decodes the payload of a response frame (without its header).
+ * @throws std::runtime_error If the payload is malformed.
+ */
+    std::vector<BattleResult> Protocol::decodeResponse(const std::vector<std::uint8_t> &payload) {
+        Reader in(payload);
+        std::uint32_t count = in.u32();
+        std::vector<BattleResult> results;
+        for (std::uint32_t i = 0; i < count; i++) {
+            BattleResult result;
+            std::uint8_t winner = in.u8();
+            if (winner > static_cast<std::uint8_t>(BattleWinner::None)) {
+                throw std::runtime_error("Error: Unknown winner.");
+            }
+            result.winner = static_cast<BattleWinner>(winner);
+            result.rounds = in.i32();
+            result.survivorsA = in.i32();
+            result.survivorsB = in.i32();
+            result.damageDealtA = in.i32();
+            result.damageDealtB = in.i32();
+            result.hitPointsA = in.i32();
+            result.hitPointsB = in.i32();
+            results.push_back(result);
+        }
+        in.finish();
+        return results;
+    }
+
+/**
+ * @brief Checks a frame header and returns the length of the payload that follows it.
+ * @param header The HEADER_SIZE bytes of the header.
+ * @param expectedMagic REQUEST_MAGIC or RESPONSE_MAGIC.
+ * @throws std::runtime_error If the magic does not match or the payload is larger than MAX_PAYLOAD.
+ */
+    std::uint32_t Protocol::payloadLength(const std::uint8_t *header, std::uint32_t expectedMagic) {
+        std::uint32_t magic = 0;
+        std::uint32_t length = 0;
+        for (std::size_t i = 0; i < 4; i++) {
+            magic |= std::uint32_t{header[i]} << (8 * i);
+            length |= std::uint32_t{header[4 + i]} << (8 * i);
+        }
+        if (magic != expectedMagic) {
+            throw std::runtime_error("Error: Bad frame magic.");
+        }
+        if (length > MAX_PAYLOAD) {
+            throw std::runtime_error("Error: Frame too large.");
+        }
+        return length;
+    }
+
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Protocol.hpp
+ * @brief Compact binary framing of battle scenarios and results, used by the simulation server and its clients.
+ * A frame is a little endian header (magic, payload length) followed by the payload. Scenario payloads carry what
+ * a battle depends on: for every fighter its kind, location and hit points, for every team its leader. Names do not
+ * change a result, the fighters built from a description are named after their kind.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_PROTOCOL_HPP
+#define COWBOY_VS_NINJA_A_PROTOCOL_HPP
+
+#include "Battle.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ariel {
+
+    struct FighterSpec {
+        FighterKind kind = FighterKind::Cowboy;
+        double x = 0;
+        double y = 0;
+        // Hit points at the start of the battle, 0 keeps the default of the kind.
+        int hitPoints = 0;
+    };
+
+    struct TeamSpec {
+        std::vector<FighterSpec> fighters;
+        std::uint8_t leader = 0;
+    };
+
+    struct Scenario {
+        TeamSpec teamA;
+        TeamSpec teamB;
+        BattleOptions options;
+        Movement movement = Movement::FloatingPoint;
+    };
+
+    class Protocol {
+    public:
+        static const std::uint32_t REQUEST_MAGIC = 0x42564e43;   // "CNVB"
+        static const std::uint32_t RESPONSE_MAGIC = 0x52564e43;  // "CNVR"
+        static const std::size_t HEADER_SIZE = 8;
+        static const std::uint32_t MAX_PAYLOAD = 64U << 20U;
+        // Scenarios of one request, each takes an arena, a result and a pool task before its teams are checked.
+        static const std::uint32_t MAX_SCENARIOS = 4096;
+
+        static Team buildTeam(const TeamSpec &spec);
+
+        // Builds the fighters in arena instead of on the heap.
+        static Team buildTeam(const TeamSpec &spec, FighterArena &arena);
+
+        // The room buildTeam(spec, arena) needs in the arena.
+        static std::size_t arenaBytes(const TeamSpec &spec);
+
+        static std::vector<std::uint8_t> encodeRequest(const std::vector<Scenario> &scenarios);
+
+        static std::vector<Scenario> decodeRequest(const std::vector<std::uint8_t> &payload);
+
+        static std::vector<std::uint8_t> encodeResponse(const std::vector<BattleResult> &results);
+
+        static std::vector<BattleResult> decodeResponse(const std::vector<std::uint8_t> &payload);
+
+        static std::uint32_t payloadLength(const std::uint8_t *header, std::uint32_t expectedMagic);
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_PROTOCOL_HPP
@@ -0,0 +1,121 @@
+/**
+ * @file ProximityCache.cpp
+ * @brief Implements the nearest query cache of a battle.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "ProximityCache.hpp"
+#include <stdexcept>
+
+namespace ariel {
+
+/**
+ * @brief The generation of a team, the first two teams asked about get a slot.
+ * @throws std::invalid_argument If a third team is asked about, a cache belongs to one battle.
+ */
+    std::uint64_t &ProximityCache::generationOf(const Team *team) {
+        for (Generation &generation: generations) {
+            if (generation.team == team) {
+                return generation.value;
+            }
+            if (generation.team == nullptr) {
+                generation.team = team;
+                return generation.value;
+            }
+        }
+        throw std::invalid_argument("Error: A proximity cache is shared by the two teams of one battle.");
+    }
+
+/**
+ * @brief Looks up the nearest living fighter of a team from a location.
+ * @param owner The team searched.
+ * @param origin The location searched from.
+ * @param movement The movement mode of the team asking.
+ * @param ranking The ranking mode of the team asking.
+ * @param answer Set to the cached answer on a hit.
+ * @return true on a hit, false if the answer has to be computed.
+ */
+    bool ProximityCache::find(const Team *owner, const Point &origin, Movement movement, Ranking ranking,
+                              Character *&answer) {
+        std::uint64_t generation = generationOf(owner);
+        for (const Entry &entry: entries) {
+            if (entry.owner == owner && entry.generation == generation && entry.movement == movement &&
+                entry.ranking == ranking &&
+                entry.origin.getX() == origin.getX() && entry.origin.getY() == origin.getY()) {
+                answer = entry.answer;
+                hitCount++;
+                return true;
+            }
+        }
+        missCount++;
+        return false;
+    }
+
+/**
+ * @brief Remembers a computed answer, replacing the oldest one.
+ */
+    void ProximityCache::store(const Team *owner, const Point &origin, Movement movement, Ranking ranking,
+                               Character *answer) {
+        entries[next] = {owner, origin, movement, ranking, generationOf(owner), answer};
+        next = (next + 1) % entries.size();
+    }
+
+/**
+ * @brief Drops the answers about a team, after one of its fighters died or moved.
+ */
+    void ProximityCache::changed(const Team *team) {
+        generationOf(team)++;
+    }
+
+/**
+ * @brief Keeps the distances between the fighters of the two teams of the battle, if they fit in the matrix.
+ * The matrix is allocated on the first call that fits and freed by a call that does not.
+ * @return true if the matrix holds them.
+ */
+    bool ProximityCache::attach(const Team &first, const Team &second) {
+        if (!DistanceMatrix::fits(first, second)) {
+            matrix.reset();
+            return false;
+        }
+        if (!matrix) {
+            matrix = std::make_unique<DistanceMatrix>();
+        }
+        return matrix->attach(first, second);
+    }
+
+/**
+ * @brief Marks a fighter as moved in the distance matrix, Team::attack calls it for every move.
+ */
+    void ProximityCache::moved(const Character *fighter) {
+        if (matrix) {
+            matrix->moved(fighter);
+        }
+    }
+
+/**
+ * @brief The distance matrix of the battle, nullptr unless attach() succeeded.
+ */
+    DistanceMatrix *ProximityCache::distances() {
+        return matrix.get();
+    }
+
+    const DistanceMatrix *ProximityCache::distances() const {
+        return matrix.get();
+    }
+
+/**
+ * @brief Number of queries answered from the cache.
+ */
+    std::size_t ProximityCache::hits() const {
+        return hitCount;
+    }
+
+/**
+ * @brief Number of queries that had to be computed.
+ */
+    std::size_t ProximityCache::misses() const {
+        return missCount;
+    }
+
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ProximityCache.hpp
+ * @brief Answers of nearest living fighter queries shared by the attacks of one battle.
+ * Both teams of a battle ask where the nearest fighter of a team is from a leader's location, and most of the time
+ * nothing that could change the answer happened since the last time. Every team has a generation, bumped by
+ * Team::attack when one of its fighters dies or moves, and a cached answer is used only while the generation of
+ * its team is unchanged. Queries the cache misses can be answered by the distance matrix of a small battle.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_PROXIMITYCACHE_HPP
+#define COWBOY_VS_NINJA_A_PROXIMITYCACHE_HPP
+
+#include "Team.hpp"
+#include "DistanceMatrix.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace ariel {
+
+    class ProximityCache {
+    private:
+        struct Generation {
+            const Team *team = nullptr;
+            std::uint64_t value = 0;
+        };
+
+        struct Entry {
+            const Team *owner = nullptr;
+            Point origin{0, 0};
+            // The arithmetic of the asking team, the answers of the movement and ranking modes can differ.
+            Movement movement = Movement::FloatingPoint;
+            Ranking ranking = Ranking::Exact;
+            std::uint64_t generation = 0;
+            Character *answer = nullptr;
+        };
+
+        std::array<Generation, 2> generations;
+        std::array<Entry, 8> entries;
+        std::size_t next = 0;
+        std::size_t hitCount = 0;
+        std::size_t missCount = 0;
+        // Allocated by the first attach() that fits, a battle without a matrix does not pay for one.
+        std::unique_ptr<DistanceMatrix> matrix;
+
+        std::uint64_t &generationOf(const Team *team);
+
+    public:
+        bool find(const Team *owner, const Point &origin, Movement movement, Ranking ranking, Character *&answer);
+
+        void store(const Team *owner, const Point &origin, Movement movement, Ranking ranking, Character *answer);
+
+        void changed(const Team *team);
+
+        bool attach(const Team &first, const Team &second);
+
+        void moved(const Character *fighter);
+
+        DistanceMatrix *distances();
+
+        const DistanceMatrix *distances() const;
+
+        std::size_t hits() const;
+
+        std::size_t misses() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_PROXIMITYCACHE_HPP
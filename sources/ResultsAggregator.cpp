@@ -0,0 +1,100 @@
+/**
+ * @file ResultsAggregator.cpp
+ * @brief Implements the sharded results tally.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "ResultsAggregator.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace ariel {
+
+    namespace {
+        std::atomic<std::size_t> nextThread{0};
+
+        /**
+         * @brief A small number given to each thread on its first record, threads spread over the shards by it.
+         */
+        std::size_t threadNumber() {
+            thread_local const std::size_t number = nextThread.fetch_add(1, std::memory_order_relaxed);
+            return number;
+        }
+    }
+
+/**
+ * @brief Constructs an empty tally.
+ * @param shardCount Number of shards, 0 means four per hardware thread (at least 64).
+ */
+    ResultsAggregator::ResultsAggregator(std::size_t shardCount) : shardCount(shardCount) {
+        if (this->shardCount == 0) {
+            this->shardCount = std::max<std::size_t>(64, 4 * std::size_t{std::thread::hardware_concurrency()});
+        }
+        shards = std::make_unique<Shard[]>(this->shardCount);
+    }
+
+/**
+ * @brief Number of shards of the tally.
+ */
+    std::size_t ResultsAggregator::shardsInUse() const {
+        return this->shardCount;
+    }
+
+/**
+ * @brief Adds one battle to the tally. Lock free, a thread only touches its own shard.
+ * @param result The outcome of the battle.
+ */
+    void ResultsAggregator::record(const BattleResult &result) {
+        Shard &shard = shards[threadNumber() % shardCount];
+        shard.battles.fetch_add(1, std::memory_order_relaxed);
+        if (result.winner == BattleWinner::TeamA) {
+            shard.winsA.fetch_add(1, std::memory_order_relaxed);
+        } else if (result.winner == BattleWinner::TeamB) {
+            shard.winsB.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            shard.unfinished.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.rounds.fetch_add(static_cast<std::uint64_t>(result.rounds), std::memory_order_relaxed);
+        shard.survivingHitPointsA.fetch_add(static_cast<std::uint64_t>(result.hitPointsA),
+                                            std::memory_order_relaxed);
+        shard.survivingHitPointsB.fetch_add(static_cast<std::uint64_t>(result.hitPointsB),
+                                            std::memory_order_relaxed);
+    }
+
+/**
+ * @brief Merges the shards. Records made concurrently with the merge may be only partly included.
+ * @return The totals over all recorded battles.
+ */
+    ResultTotals ResultsAggregator::snapshot() const {
+        ResultTotals totals;
+        for (std::size_t index = 0; index < shardCount; index++) {
+            const Shard &shard = shards[index];
+            totals.battles += shard.battles.load(std::memory_order_relaxed);
+            totals.winsA += shard.winsA.load(std::memory_order_relaxed);
+            totals.winsB += shard.winsB.load(std::memory_order_relaxed);
+            totals.unfinished += shard.unfinished.load(std::memory_order_relaxed);
+            totals.rounds += shard.rounds.load(std::memory_order_relaxed);
+            totals.survivingHitPointsA += shard.survivingHitPointsA.load(std::memory_order_relaxed);
+            totals.survivingHitPointsB += shard.survivingHitPointsB.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+
+/**
+ * @brief Clears the tally, must not run concurrently with record.
+ */
+    void ResultsAggregator::reset() {
+        for (std::size_t index = 0; index < shardCount; index++) {
+            Shard &shard = shards[index];
+            shard.battles = 0;
+            shard.winsA = 0;
+            shard.winsB = 0;
+            shard.unfinished = 0;
+            shard.rounds = 0;
+            shard.survivingHitPointsA = 0;
+            shard.survivingHitPointsB = 0;
+        }
+    }
+
+}
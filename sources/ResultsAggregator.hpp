@@ -0,0 +1,60 @@
+/**
+ * @file ResultsAggregator.hpp
+ * @brief Lock free tally of battle results for concurrent runners.
+ * Every thread writes to its own cache line aligned shard with relaxed atomic adds, readers merge the shards.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_RESULTSAGGREGATOR_HPP
+#define COWBOY_VS_NINJA_A_RESULTSAGGREGATOR_HPP
+
+#include "Battle.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace ariel {
+
+    struct ResultTotals {
+        std::uint64_t battles = 0;
+        std::uint64_t winsA = 0;
+        std::uint64_t winsB = 0;
+        std::uint64_t unfinished = 0;
+        std::uint64_t rounds = 0;
+        std::uint64_t survivingHitPointsA = 0;
+        std::uint64_t survivingHitPointsB = 0;
+    };
+
+    class ResultsAggregator {
+    private:
+        static const std::size_t CACHE_LINE = 64;
+
+        struct alignas(CACHE_LINE) Shard {
+            std::atomic<std::uint64_t> battles{0};
+            std::atomic<std::uint64_t> winsA{0};
+            std::atomic<std::uint64_t> winsB{0};
+            std::atomic<std::uint64_t> unfinished{0};
+            std::atomic<std::uint64_t> rounds{0};
+            std::atomic<std::uint64_t> survivingHitPointsA{0};
+            std::atomic<std::uint64_t> survivingHitPointsB{0};
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        std::size_t shardCount;
+
+    public:
+        explicit ResultsAggregator(std::size_t shardCount = 0);
+
+        std::size_t shardsInUse() const;
+
+        void record(const BattleResult &result);
+
+        ResultTotals snapshot() const;
+
+        void reset();
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_RESULTSAGGREGATOR_HPP
@@ -0,0 +1,358 @@
+/**
+ * @file SimulationServer.cpp
+ * @brief Implements the simulation server, its latency tracking and its client.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "SimulationServer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <latch>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ariel {
+
+    namespace {
+
+        sockaddr_un socketAddress(const std::string &path) {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                throw std::invalid_argument("Error: Invalid socket path.");
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return address;
+        }
+
+        /**
+         * @brief Reads exactly count bytes.
+         * @return false if the peer closed the connection before the first byte, true once all bytes were read.
+         * @throws std::runtime_error On a read error or a connection closed in the middle of the bytes.
+         */
+        bool readAll(int descriptor, std::uint8_t *buffer, std::size_t count) {
+            std::size_t done = 0;
+            while (done < count) {
+                ssize_t got = ::read(descriptor, buffer + done, count - done);
+                if (got < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (got <= 0) {
+                    if (got == 0 && done == 0) {
+                        return false;
+                    }
+                    throw std::runtime_error("Error: Connection lost while reading.");
+                }
+                done += static_cast<std::size_t>(got);
+            }
+            return true;
+        }
+
+        void writeAll(int descriptor, const std::vector<std::uint8_t> &frame) {
+            std::size_t done = 0;
+            while (done < frame.size()) {
+                ssize_t sent = ::send(descriptor, frame.data() + done, frame.size() - done, MSG_NOSIGNAL);
+                if (sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (sent <= 0) {
+                    throw std::runtime_error("Error: Connection lost while writing.");
+                }
+                done += static_cast<std::size_t>(sent);
+            }
+        }
+
+        /**
+         * @brief Reads one frame into payload, reusing its capacity.
+         * @return false if the peer closed the connection between frames.
+         */
+        bool readFrame(int descriptor, std::uint32_t magic, std::vector<std::uint8_t> &payload) {
+            std::uint8_t header[Protocol::HEADER_SIZE];
+            if (!readAll(descriptor, header, Protocol::HEADER_SIZE)) {
+                return false;
+            }
+            payload.resize(Protocol::payloadLength(header, magic));
+            if (!payload.empty() && !readAll(descriptor, payload.data(), payload.size())) {
+                throw std::runtime_error("Error: Connection lost while reading.");
+            }
+            return true;
+        }
+    }
+
+/**
+ * @brief Constructs a tracker of the latencies of the last window requests.
+ */
+    LatencyTracker::LatencyTracker(std::size_t window) : samples(), next(0), total(0) {
+        samples.reserve(std::max<std::size_t>(window, 1));
+    }
+
+/**
+ * @brief Records the latency of one request, replacing the oldest one once the window is full.
+ */
+    void LatencyTracker::record(double microseconds) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (samples.size() < samples.capacity()) {
+            samples.push_back(microseconds);
+        } else {
+            samples[next] = microseconds;
+            next = (next + 1) % samples.size();
+        }
+        total++;
+    }
+
+/**
+ * @brief A latency percentile over the window, e.g. percentile(0.99) for the p99.
+ * @param fraction Between 0 and 1.
+ * @return The percentile in microseconds, 0 if nothing was recorded.
+ * @throws std::invalid_argument If fraction is not between 0 and 1.
+ */
+    double LatencyTracker::percentile(double fraction) const {
+        if (fraction < 0 || fraction > 1) {
+            throw std::invalid_argument("Error: Percentile must be between 0 and 1.");
+        }
+        std::vector<double> sorted;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            sorted = samples;
+        }
+        if (sorted.empty()) {
+            return 0;
+        }
+        auto rank = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank), sorted.end());
+        return sorted[rank];
+    }
+
+/**
+ * @brief Number of requests recorded since construction, including those that left the window.
+ */
+    std::size_t LatencyTracker::count() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return total;
+    }
+
+/**
+ * @brief Constructs a server, nothing listens before start().
+ * @param socketPath Path of the Unix domain socket.
+ * @param pool The thread pool the scenarios run on, it must outlive the server.
+ * @param budget Budget every scenario reserves its estimated bytes from before building its teams, nullptr means no
+ * limit. It must outlive the server.
+ */
+    SimulationServer::SimulationServer(std::string socketPath, ThreadPool &pool, MemoryBudget *budget)
+            : path(std::move(socketPath)), pool(pool), budget(budget), listener(-1), running(false) {}
+
+/**
+ * @brief Stops the server if it is still running.
+ */
+    SimulationServer::~SimulationServer() {
+        stop();
+    }
+
+/**
+ * @brief Binds the socket (replacing a stale socket file at the path) and starts accepting connections.
+ * @throws std::runtime_error If the server is already running or the socket cannot be bound.
+ */
+    void SimulationServer::start() {
+        if (running) {
+            throw std::runtime_error("Error: Server already running.");
+        }
+        sockaddr_un address = socketAddress(path);
+        listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listener < 0) {
+            throw std::runtime_error("Error: Cannot create socket.");
+        }
+        ::unlink(path.c_str());
+        if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(listener, SOMAXCONN) != 0) {
+            ::close(listener);
+            listener = -1;
+            throw std::runtime_error("Error: Cannot listen on " + path + ".");
+        }
+        running = true;
+        acceptor = std::thread(&SimulationServer::acceptLoop, this);
+    }
+
+/**
+ * @brief Stops accepting, disconnects the clients, waits for their threads and removes the socket file.
+ */
+    void SimulationServer::stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        ::shutdown(listener, SHUT_RDWR);
+        acceptor.join();
+        ::close(listener);
+        listener = -1;
+        {
+            std::lock_guard<std::mutex> guard(connectionsLock);
+            for (auto &connection: connections) {
+                if (!connection->done) {
+                    ::shutdown(connection->descriptor, SHUT_RDWR);
+                }
+            }
+        }
+        for (auto &connection: connections) {
+            connection->thread.join();
+        }
+        connections.clear();
+        ::unlink(path.c_str());
+    }
+
+    void SimulationServer::acceptLoop() {
+        while (running) {
+            int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                break;
+            }
+            reapFinished();
+            std::lock_guard<std::mutex> guard(connectionsLock);
+            auto &connection = connections.emplace_back(std::make_unique<Connection>());
+            connection->descriptor = client;
+            connection->thread = std::thread(&SimulationServer::serve, this, std::ref(*connection));
+        }
+    }
+
+/**
+ * @brief Joins the threads of closed connections, so a long running server does not accumulate them.
+ */
+    void SimulationServer::reapFinished() {
+        std::lock_guard<std::mutex> guard(connectionsLock);
+        for (auto it = connections.begin(); it != connections.end();) {
+            if ((*it)->done) {
+                (*it)->thread.join();
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+/**
+ * @brief Serves the requests of one connection until it closes. A malformed request closes the connection.
+ * The payload buffer and the fighter arenas keep their memory from one request to the next.
+ */
+    void SimulationServer::serve(Connection &connection) {
+        std::vector<std::uint8_t> payload;
+        std::vector<FighterArena> arenas;
+        try {
+            while (readFrame(connection.descriptor, Protocol::REQUEST_MAGIC, payload)) {
+                auto start = std::chrono::steady_clock::now();
+                std::vector<BattleResult> results = simulate(Protocol::decodeRequest(payload), arenas);
+                writeAll(connection.descriptor, Protocol::encodeResponse(results));
+                latency.record(std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - start).count());
+            }
+        } catch (const std::exception &) {
+            // The client gets a closed connection, the server keeps serving the others.
+        }
+        std::lock_guard<std::mutex> guard(connectionsLock);
+        ::close(connection.descriptor);
+        connection.done = true;
+    }
+
+/**
+ * @brief Runs the scenarios of one request on the pool and waits only for them, not for other requests.
+ * Each scenario builds its teams in its own arena of the connection, so no fighter is allocated on the heap. With a
+ * budget, a scenario reserves estimatedBattleBytes() before its teams are built and holds the bytes until its battle
+ * is over.
+ * @param scenarios The scenarios of the request.
+ * @param arenas The arenas of the connection, one more is added for each scenario beyond their number.
+ * @throws The first exception of a scenario (e.g. an invalid team description, or std::runtime_error if it does
+ * not fit in the budget).
+ */
+    std::vector<BattleResult>
+    SimulationServer::simulate(const std::vector<Scenario> &scenarios, std::vector<FighterArena> &arenas) {
+        if (arenas.size() < scenarios.size()) {
+            arenas.resize(scenarios.size());
+        }
+        std::vector<BattleResult> results(scenarios.size());
+        std::vector<std::exception_ptr> errors(scenarios.size());
+        std::latch finished(static_cast<std::ptrdiff_t>(scenarios.size()));
+        for (std::size_t index = 0; index < scenarios.size(); index++) {
+            pool.submit([&, index] {
+                try {
+                    const Scenario &scenario = scenarios[index];
+                    MemoryReservation reserved;
+                    if (budget != nullptr) {
+                        reserved = MemoryReservation(*budget, estimatedBattleBytes(
+                                scenario.teamA.fighters.size(), scenario.teamB.fighters.size(), scenario.options));
+                    }
+                    FighterArena &arena = arenas[index];
+                    arena.reset(Protocol::arenaBytes(scenario.teamA) + Protocol::arenaBytes(scenario.teamB));
+                    Team teamA = Protocol::buildTeam(scenario.teamA, arena);
+                    Team teamB = Protocol::buildTeam(scenario.teamB, arena);
+                    teamA.setMovement(scenario.movement);
+                    teamB.setMovement(scenario.movement);
+                    results[index] = runBattle(teamA, teamB, scenario.options);
+                } catch (...) {
+                    errors[index] = std::current_exception();
+                }
+                finished.count_down();
+            });
+        }
+        finished.wait();
+        for (const std::exception_ptr &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        return results;
+    }
+
+/**
+ * @brief A latency percentile of the recent requests, from the first byte read to the last byte written.
+ * @param fraction Between 0 and 1, e.g. 0.99 for the p99.
+ * @return The latency in microseconds.
+ */
+    double SimulationServer::latencyPercentile(double fraction) const {
+        return latency.percentile(fraction);
+    }
+
+/**
+ * @brief Number of requests answered since the server was constructed.
+ */
+    std::size_t SimulationServer::requestsServed() const {
+        return latency.count();
+    }
+
+/**
+ * @brief Connects to a running server.
+ * @throws std::runtime_error If nothing listens on the path.
+ */
+    SimulationClient::SimulationClient(const std::string &socketPath) : descriptor(-1) {
+        sockaddr_un address = socketAddress(socketPath);
+        descriptor = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (descriptor < 0) {
+            throw std::runtime_error("Error: Cannot create socket.");
+        }
+        if (::connect(descriptor, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Error: Cannot connect to " + socketPath + ".");
+        }
+    }
+
+    SimulationClient::~SimulationClient() {
+        ::close(descriptor);
+    }
+
+/**
+ * @brief Sends one batch of scenarios and waits for their results, in the same order.
+ * @throws std::runtime_error If the server closed the connection, e.g. because the request was invalid.
+ */
+    std::vector<BattleResult> SimulationClient::run(const std::vector<Scenario> &scenarios) {
+        writeAll(descriptor, Protocol::encodeRequest(scenarios));
+        std::vector<std::uint8_t> payload;
+        if (!readFrame(descriptor, Protocol::RESPONSE_MAGIC, payload)) {
+            throw std::runtime_error("Error: Connection closed by the server.");
+        }
+        return Protocol::decodeResponse(payload);
+    }
+
+}
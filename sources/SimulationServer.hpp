@@ -0,0 +1,115 @@
+/**
+ * @file SimulationServer.hpp
+ * @brief A long running battle simulation server on a local Unix domain socket, and its client.
+ * Every connection sends request frames of batched scenarios (see Protocol.hpp) and gets one response frame per request.
+ * The scenarios of a request run on a shared, already started thread pool, within an optional memory budget.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_SIMULATIONSERVER_HPP
+#define COWBOY_VS_NINJA_A_SIMULATIONSERVER_HPP
+
+#include "Protocol.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ariel {
+
+    /**
+     * @brief Keeps the latencies of the most recent requests in a ring and reports percentiles over them.
+     */
+    class LatencyTracker {
+    private:
+        mutable std::mutex lock;
+        std::vector<double> samples;
+        std::size_t next;
+        std::size_t total;
+
+    public:
+        explicit LatencyTracker(std::size_t window = 4096);
+
+        void record(double microseconds);
+
+        double percentile(double fraction) const;
+
+        std::size_t count() const;
+    };
+
+    class SimulationServer {
+    private:
+        struct Connection {
+            int descriptor = -1;
+            std::thread thread;
+            std::atomic<bool> done{false};
+        };
+
+        std::string path;
+        ThreadPool &pool;
+        MemoryBudget *budget;
+        int listener;
+        std::atomic<bool> running;
+        std::thread acceptor;
+        std::mutex connectionsLock;
+        std::list<std::unique_ptr<Connection>> connections;
+        LatencyTracker latency;
+
+        void acceptLoop();
+
+        void serve(Connection &connection);
+
+        std::vector<BattleResult> simulate(const std::vector<Scenario> &scenarios, std::vector<FighterArena> &arenas);
+
+        void reapFinished();
+
+    public:
+        SimulationServer(std::string socketPath, ThreadPool &pool, MemoryBudget *budget = nullptr);
+
+        ~SimulationServer();
+
+        void start();
+
+        void stop();
+
+        double latencyPercentile(double fraction) const;
+
+        std::size_t requestsServed() const;
+
+        SimulationServer(const SimulationServer &) = delete;
+
+        SimulationServer &operator=(const SimulationServer &) = delete;
+
+        SimulationServer(SimulationServer &&) = delete;
+
+        SimulationServer &operator=(SimulationServer &&) = delete;
+    };
+
+    class SimulationClient {
+    private:
+        int descriptor;
+
+    public:
+        explicit SimulationClient(const std::string &socketPath);
+
+        ~SimulationClient();
+
+        std::vector<BattleResult> run(const std::vector<Scenario> &scenarios);
+
+        SimulationClient(const SimulationClient &) = delete;
+
+        SimulationClient &operator=(const SimulationClient &) = delete;
+
+        SimulationClient(SimulationClient &&) = delete;
+
+        SimulationClient &operator=(SimulationClient &&) = delete;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_SIMULATIONSERVER_HPP
@@ -8,30 +8,98 @@
  */
 
 #include "Team.hpp"
+#include "ProximityCache.hpp"
+#include "Profiler.hpp"
 
 namespace ariel {
 
 /**
  * @brief Constructs a team with the specified leader.
  * @param leader Pointer to the leader of the team.
- * @throws std::invalid_argument If the leader pointer is invalid or the team already has ten fighters.
+ * @param capacity Maximum number of fighters, ten in the classic game.
+ * @throws std::invalid_argument If the leader pointer is invalid or the capacity is zero.
  * @throws std::runtimer_error If the leader is already member in other team.
  */
-    Team::Team(Character *leader) : leader(leader) {
+    Team::Team(Character *leader, std::size_t capacity) :
+            leader(leader), capacity(capacity), movement(Movement::FloatingPoint), ranking(Ranking::Exact),
+            arenaBase(nullptr), arenaSize(0), layout(Layout::Insertion) {
         if (!leader) {
             throw std::invalid_argument("Error: Invalid pointer to team leader.");
         }
         if (leader->isTeamMember()) {
             throw std::runtime_error("Error: The leader is already in team.");
         }
-        if (this->fighters.size() >= 10) {
-            throw std::invalid_argument("Error: The team cannot have more than ten fighters.");
+        if (capacity == 0 || capacity > UINT32_MAX) {
+            throw std::invalid_argument("Error: Invalid team capacity.");
         }
         fighters.push_back(leader);
         this->leader = leader;
         this->leader->setTeamMember(true);
     }
 
+/**
+ * @brief Constructs a team on a fighter arena: its fighters are destroyed in place and the memory left to the arena.
+ * @param leader Pointer to the leader of the team, constructed in the arena like every fighter added later.
+ * @param arena The arena the fighters are constructed in, it must outlive the team.
+ * @param capacity Maximum number of fighters.
+ * @throws The exceptions of Team(Character *, std::size_t).
+ */
+    Team::Team(Character *leader, FighterArena &arena, std::size_t capacity) : Team(leader, capacity) {
+        this->arenaBase = arena.data();
+        this->arenaSize = arena.size();
+    }
+
+/**
+ * @brief Constructs an empty team without a leader, used by clone() to skip validation.
+ */
+    Team::Team() : leader(nullptr), capacity(DEFAULT_CAPACITY), movement(Movement::FloatingPoint),
+                   ranking(Ranking::Exact), arenaBase(nullptr), arenaSize(0), layout(Layout::Insertion) {}
+
+/**
+ * @brief Move constructor, takes over the fighters and the leader of the other team.
+ * @param other The team to move from, left without fighters and without a leader.
+ */
+    Team::Team(Team &&other) noexcept:
+            leader(other.leader), fighters(std::move(other.fighters)), capacity(other.capacity),
+            movement(other.movement), ranking(other.ranking), rankingStats(other.rankingStats),
+            index(std::move(other.index)), arena(std::move(other.arena)), arenaBase(other.arenaBase),
+            arenaSize(other.arenaSize), layout(other.layout), spatialOrder(std::move(other.spatialOrder)) {
+        other.leader = nullptr;
+        other.fighters.clear();
+        other.arenaBase = nullptr;
+        other.arenaSize = 0;
+        other.spatialOrder.clear();
+    }
+
+/**
+ * @brief Move assignment, frees the current fighters and takes over those of the other team.
+ * @param other The team to move from, left without fighters and without a leader.
+ * @return This team.
+ */
+    Team &Team::operator=(Team &&other) noexcept {
+        if (this != &other) {
+            destroyFighters();
+            this->leader = other.leader;
+            this->fighters = std::move(other.fighters);
+            this->capacity = other.capacity;
+            this->movement = other.movement;
+            this->ranking = other.ranking;
+            this->rankingStats = other.rankingStats;
+            this->index = std::move(other.index);
+            this->arena = std::move(other.arena);
+            this->arenaBase = other.arenaBase;
+            this->arenaSize = other.arenaSize;
+            this->layout = other.layout;
+            this->spatialOrder = std::move(other.spatialOrder);
+            other.leader = nullptr;
+            other.fighters.clear();
+            other.arenaBase = nullptr;
+            other.arenaSize = 0;
+            other.spatialOrder.clear();
+        }
+        return *this;
+    }
+
 /**
 * @brief Get the leader of the team.
 * @return Pointer to the leader character.
@@ -51,31 +119,60 @@ namespace ariel {
 /**
  * @brief Adds a fighter to the team.
  * @param fighter Pointer to the fighter to be added.
- * @throws std::invalid_argument If the fighter pointer is invalid or the team already has ten fighters.
+ * @throws std::invalid_argument If the fighter pointer is invalid or the team is full.
+ * @throws std::runtime_error If this team has no leader (it was moved from), the fighter is not taken.
  */
     void Team::add(Character *fighter) {
         if (!fighter) {
             throw std::invalid_argument("Error: Invalid pointer to team fighter.");
         }
+        if (!this->leader) {
+            throw std::runtime_error("Error: Cannot add to a team without a leader.");
+        }
         if (fighter->isTeamMember()) {
             throw std::runtime_error("Error: The character is already in some team.");
         }
-        if (this->fighters.size() >= 10) {
-            throw std::invalid_argument("Error: The team cannot have more than ten fighters.");
+        if (this->fighters.size() >= capacity) {
+            throw std::invalid_argument("Error: The team cannot have more than " + std::to_string(capacity) +
+                                        " fighters.");
         }
         this->fighters.push_back(fighter);
         fighter->setTeamMember(true);
+        if (index) {
+            index->invalidate();
+        }
+        spatialOrder.clear();
     }
 
 /**
 * @brief Finds the new leader for the team based on the closest living character to a given location.
+* Searches of this team's own fighters go through its spatial index when it has one, with the same answer.
 * @param location The location used to calculate the distances.
 * @param fighters A vector containing pointers to the fighters in the team.
 */
     Character *
     Team::findClosestCharacter(const ariel::Point &location, const std::vector<Character *> &fighters) const {
+        if (index && &fighters == &this->fighters) {
+            return index->nearest(location, fighters);
+        }
         Character *closestCharacter = nullptr;
         double closestDistance = std::numeric_limits<double>::max();
+        if (&fighters == &this->fighters && !spatialOrder.empty()) {
+            // Memory order, a tie between equal distances still goes to the earliest turn.
+            std::uint32_t closestTurn = 0;
+            for (const SpatialSlot &slot: spatialOrder) {
+                if (slot.fighter->isAlive()) {
+                    double distance = location.distance(slot.fighter->getLocation());
+                    if (distance < closestDistance ||
+                        (closestCharacter != nullptr && distance == closestDistance && slot.turn < closestTurn)) {
+                        closestCharacter = slot.fighter;
+                        closestDistance = distance;
+                        closestTurn = slot.turn;
+                    }
+                }
+            }
+            return closestCharacter;
+        }
         for (Character *character: fighters) {
             if (character->isAlive()) {
                 double distance = location.distance(character->getLocation());
@@ -88,6 +185,316 @@ namespace ariel {
         return closestCharacter;
     }
 
+/**
+* @brief Offers every living fighter of the team to a collector, with its distance and its position in the team.
+* @param location The location the distances are measured from.
+* @param collector The answers so far, updated in place.
+*/
+    template<typename Collector>
+    void Team::collect(const ariel::Point &location, Collector &collector) const {
+        if (index) {
+            index->collect(location, fighters, collector);
+            return;
+        }
+        if (!spatialOrder.empty()) {
+            for (const SpatialSlot &slot: spatialOrder) {
+                if (slot.fighter->isAlive()) {
+                    collector.offer(slot.fighter, location.distance(slot.fighter->getLocation()), slot.turn);
+                }
+            }
+            return;
+        }
+        for (std::size_t order = 0; order < fighters.size(); order++) {
+            if (fighters[order]->isAlive()) {
+                collector.offer(fighters[order], location.distance(fighters[order]->getLocation()),
+                                static_cast<std::uint32_t>(order));
+            }
+        }
+    }
+
+    template void Team::collect(const Point &location, RadiusQuery &collector) const;
+
+/**
+* @brief Finds the k living fighters nearest to a location, through the spatial index when there is one.
+* Ties go to the lower position in the team, like findClosestCharacter. Nothing is allocated.
+* @param location The location the distances are measured from.
+* @param hits Where the fighters are written, nearest first. Its size is k.
+* @return How many fighters were written, less than k when fewer are alive.
+*/
+    std::size_t Team::kNearest(const ariel::Point &location, std::span<NearestHit> hits) const {
+        NearestHits nearest(hits);
+        collect(location, nearest);
+        return nearest.finish();
+    }
+
+/**
+* @brief Finds the closest living fighter of a team, answered from the battle's proximity cache when it can be.
+* Exact floating point queries the cache misses are answered from the battle's distance matrix when it holds them.
+* @param location The location used to calculate the distances.
+* @param owner The team whose fighters are searched, this team or the enemy.
+* @param proximity Answers shared by the attacks of the battle, nullptr to always search.
+* @return The closest living character, nullptr if none is alive.
+*/
+    Character *Team::nearest(const ariel::Point &location, const Team &owner, ProximityCache *proximity) const {
+        Character *cached = nullptr;
+        if (proximity != nullptr && proximity->find(&owner, location, this->movement, this->ranking, cached)) {
+            return cached;
+        }
+        Character *closest = nullptr;
+        if (proximity == nullptr || this->movement != Movement::FloatingPoint || this->ranking != Ranking::Exact ||
+            proximity->distances() == nullptr || !proximity->distances()->nearest(location, owner, closest)) {
+            closest = nearest(location, owner);
+        }
+        if (proximity != nullptr) {
+            proximity->store(&owner, location, this->movement, this->ranking, closest);
+        }
+        return closest;
+    }
+
+/**
+* @brief Finds the closest living fighter of a team using the arithmetic of this team's movement and ranking modes.
+* In deterministic mode distances are compared as integer squared distances, ties keep the first one checked.
+* Approximate ranking applies to floating point movement only.
+* @param location The location used to calculate the distances.
+* @param owner The team whose fighters are searched, this team or the enemy.
+* @return The closest living character, nullptr if none is alive.
+*/
+    Character *Team::nearest(const ariel::Point &location, const Team &owner) const {
+        const std::vector<Character *> &candidates = owner.fighters;
+        if (this->movement == Movement::FloatingPoint) {
+            if (this->ranking == Ranking::Exact || owner.index) {
+                return owner.findClosestCharacter(location, candidates);
+            }
+            Character *approximate = approximateNearest(location, owner);
+            if (this->ranking == Ranking::Audited) {
+                rankingStats.queries++;
+                if (approximate != owner.findClosestCharacter(location, candidates)) {
+                    rankingStats.mismatches++;
+                }
+            }
+            return approximate;
+        }
+        const FixedPoint origin(location);
+        Character *closestCharacter = nullptr;
+        std::int64_t closestDistance = std::numeric_limits<std::int64_t>::max();
+        for (Character *character: candidates) {
+            if (character->isAlive()) {
+                std::int64_t distance = origin.squaredDistance(FixedPoint(character->getLocation()));
+                if (distance < closestDistance) {
+                    closestCharacter = character;
+                    closestDistance = distance;
+                }
+            }
+        }
+        return closestCharacter;
+    }
+
+/**
+* @brief The fighter this team targets from a location, the same search attack() makes for its victims.
+* @param location The location searched from, usually this team's leader's.
+* @param owner The team searched.
+* @return The target, nullptr if none of owner's fighters is alive.
+*/
+    Character *Team::pickTarget(const ariel::Point &location, const Team &owner) const {
+        return nearest(location, owner);
+    }
+
+/**
+* @brief Finds a living fighter of a team by approximate distance. Its exact distance is at most
+* (1 + e) / (1 - e) times the closest one, about 8.2% more, e being APPROXIMATE_DISTANCE_ERROR.
+* Ties keep the earliest in turn order.
+* @param location The location used to calculate the distances.
+* @param owner The team whose fighters are searched.
+* @return The chosen character, nullptr if none is alive.
+*/
+    Character *Team::approximateNearest(const ariel::Point &location, const Team &owner) const {
+        Character *closestCharacter = nullptr;
+        double closestDistance = std::numeric_limits<double>::max();
+        for (Character *character: owner.fighters) {
+            if (character->isAlive()) {
+                double distance = location.approximateDistance(character->getLocation());
+                if (distance < closestDistance) {
+                    closestCharacter = character;
+                    closestDistance = distance;
+                }
+            }
+        }
+        return closestCharacter;
+    }
+
+/**
+* @brief Getter for the maximum number of fighters.
+*/
+    std::size_t Team::getCapacity() const {
+        return this->capacity;
+    }
+
+/**
+* @brief Getter for how nearest queries on this team's fighters are answered.
+*/
+    Indexing Team::getIndexing() const {
+        return index ? Indexing::Spatial : Indexing::LinearScan;
+    }
+
+/**
+* @brief Selects how nearest queries on this team's fighters are answered, the answers are the same either way.
+* @param newIndexing LinearScan, or Spatial for large rosters.
+*/
+    void Team::setIndexing(Indexing newIndexing) {
+        if (newIndexing == Indexing::Spatial && !index) {
+            index = std::make_unique<TeamIndex>();
+        } else if (newIndexing == Indexing::LinearScan && index) {
+            index->detach(fighters);
+            index.reset();
+        }
+    }
+
+/**
+* @brief Getter for the movement mode used by attack.
+* @return The movement mode of the team.
+*/
+    Movement Team::getMovement() const {
+        return this->movement;
+    }
+
+/**
+* @brief Sets how the ninjas of this team move and how targets are ranked during attack.
+* @param newMovement The new movement mode.
+*/
+    void Team::setMovement(Movement newMovement) {
+        this->movement = newMovement;
+    }
+
+/**
+* @brief Getter for how this team ranks fighters by distance when it picks victims and leaders.
+*/
+    Ranking Team::getRanking() const {
+        return this->ranking;
+    }
+
+/**
+* @brief Selects how this team ranks fighters by distance, exactly or approximately for mass battles.
+*/
+    void Team::setRanking(Ranking newRanking) {
+        this->ranking = newRanking;
+    }
+
+/**
+* @brief How many approximate picks were audited and how many differed from the exact pick, see Ranking::Audited.
+*/
+    RankingStats Team::getRankingStats() const {
+        return this->rankingStats;
+    }
+
+/**
+* @brief Getter for how the fighters of this team are laid out in memory.
+*/
+    Layout Team::getLayout() const {
+        return this->layout;
+    }
+
+/**
+* @brief Selects how the fighters are laid out in memory. Switching to Morton lays them out at once.
+* Laying out moves the fighters, pointers to them taken before are no longer valid, getFighters() has the new ones.
+*/
+    void Team::setLayout(Layout newLayout) {
+        this->layout = newLayout;
+        if (newLayout == Layout::Morton) {
+            relayout();
+        } else {
+            spatialOrder.clear();
+        }
+    }
+
+    namespace {
+        // Spreads the 32 bits of value to the even bits of the result.
+        std::uint64_t spreadBits(std::uint64_t value) {
+            value = (value | (value << 16)) & 0x0000FFFF0000FFFFULL;
+            value = (value | (value << 8)) & 0x00FF00FF00FF00FFULL;
+            value = (value | (value << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            value = (value | (value << 2)) & 0x3333333333333333ULL;
+            value = (value | (value << 1)) & 0x5555555555555555ULL;
+            return value;
+        }
+
+        // Position of a coordinate on a grid of 2^32 cells over [low, low + size].
+        std::uint64_t cellOf(double coordinate, double low, double size) {
+            const double cells = 4294967295.0;
+            return static_cast<std::uint64_t>(size > 0 ? (coordinate - low) / size * cells : 0);
+        }
+    }
+
+/**
+* @brief Packs the fighters into a new arena in Z-order of their current locations, when the layout is Morton.
+* The turn order and every answer stay the same. Called again as ninjas move, for example by a battle every few
+* rounds. Pointers to the fighters taken before are no longer valid, getFighters() and getLeader() have the new ones.
+* @param enemyTeam The team this one is fighting, nullptr if none. An attack can make one of this team's fighters
+* the enemy's leader, that pointer is updated too.
+*/
+    void Team::relayout(Team *enemyTeam) {
+        if (layout != Layout::Morton || fighters.empty()) {
+            return;
+        }
+        double minX = fighters[0]->getLocation().getX();
+        double minY = fighters[0]->getLocation().getY();
+        double maxX = minX;
+        double maxY = minY;
+        for (const Character *fighter: fighters) {
+            minX = std::min(minX, fighter->getLocation().getX());
+            minY = std::min(minY, fighter->getLocation().getY());
+            maxX = std::max(maxX, fighter->getLocation().getX());
+            maxY = std::max(maxY, fighter->getLocation().getY());
+        }
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> codes;
+        codes.reserve(fighters.size());
+        for (std::size_t turn = 0; turn < fighters.size(); turn++) {
+            const Point location = fighters[turn]->getLocation();
+            std::uint64_t code = spreadBits(cellOf(location.getX(), minX, maxX - minX)) |
+                                 (spreadBits(cellOf(location.getY(), minY, maxY - minY)) << 1);
+            codes.emplace_back(code, static_cast<std::uint32_t>(turn));
+        }
+        std::sort(codes.begin(), codes.end());
+
+        const std::size_t alignment = alignof(std::max_align_t);
+        std::size_t total = 0;
+        for (const Character *fighter: fighters) {
+            total += (fighter->footprint() + alignment - 1) / alignment * alignment;
+        }
+        auto packed = std::make_unique<std::byte[]>(total);
+        std::vector<Character *> moved(fighters.size());
+        spatialOrder.clear();
+        spatialOrder.reserve(fighters.size());
+        std::size_t offset = 0;
+        for (const auto &code: codes) {
+            Character *fighter = fighters[code.second];
+            Character *copy = fighter->cloneInto(packed.get() + offset);
+            copy->setTeamMember(true);
+            moved[code.second] = copy;
+            spatialOrder.push_back({copy, code.second});
+            if (fighter == this->leader) {
+                this->leader = copy;
+            }
+            if (enemyTeam != nullptr && fighter == enemyTeam->leader) {
+                enemyTeam->leader = copy;
+            }
+            offset += (fighter->footprint() + alignment - 1) / alignment * alignment;
+        }
+        for (Character *fighter: fighters) {
+            if (inArena(fighter)) {
+                fighter->~Character();
+            } else {
+                delete fighter;
+            }
+        }
+        fighters = std::move(moved);
+        arena = std::move(packed);
+        arenaBase = arena.get();
+        arenaSize = total;
+        if (index) {
+            index->invalidate();
+        }
+    }
+
 /**
  * @brief Attacks the enemy team and handles various scenarios, including leader replacement and victim selection.
  * @param enemyTeam Pointer to the enemy team.
@@ -95,6 +502,18 @@ namespace ariel {
  * @throw std::invalid_argument If the ninja type dont fit to the three type: Young,Trained,Old Ninja.
  */
     void Team::attack(ariel::Team *enemyTeam) {
+        attack(enemyTeam, nullptr);
+    }
+
+/**
+ * @brief Attacks the enemy team, sharing nearest query answers with the other attacks of the battle.
+ * Deaths of enemies and moves of this team's ninjas are reported to the cache, they are the only changes an attack
+ * makes that can change a nearest answer.
+ * @param enemyTeam Pointer to the enemy team.
+ * @param proximity The cache of the battle, nullptr to search every time.
+ * @throws std::invalid_argument If the enemyTeam pointer is invalid.
+ */
+    void Team::attack(ariel::Team *enemyTeam, ProximityCache *proximity) {
         if (!enemyTeam) {
             throw std::invalid_argument("Error: Invalid pointer to enemy team.");
         }
@@ -105,58 +524,125 @@ namespace ariel {
             throw std::runtime_error("Error: One of the teams was completely eliminated.");
         }
         if (!(this->leader->isAlive())) {
+            PROFILE_PHASE(LeaderElection);
             Point leaderLocation = this->leader->getLocation();
-            Character *newLeader = findClosestCharacter(leaderLocation, this->getFighters());
+            Character *newLeader = nearest(leaderLocation, *this, proximity);
             this->leader = newLeader;
         }
-        Character *victim = findClosestCharacter(this->leader->getLocation(), enemyTeam->getFighters());
+        Character *victim = nullptr;
+        {
+            PROFILE_PHASE(VictimSearch);
+            victim = nearest(this->leader->getLocation(), *enemyTeam, proximity);
+        }
 
-        for (Character *attacker: fighters) {
-            if (attacker->isAlive() && victim->isAlive()) {
-                if (Cowboy *cowboy = dynamic_cast<Cowboy *>(attacker)) {
-                    if (cowboy->hasBullets()) {
-                        cowboy->shoot(victim);
-                    } else {
-                        cowboy->reload();
+        {
+            PROFILE_PHASE(CowboyPhase);
+            for (Character *attacker: fighters) {
+                if (attacker->isAlive() && victim->isAlive()) {
+                    if (Cowboy *cowboy = dynamic_cast<Cowboy *>(attacker)) {
+                        if (cowboy->hasBullets()) {
+                            cowboy->shoot(victim);
+                        } else {
+                            cowboy->reload();
+                        }
                     }
                 }
-            }
-            if (this->stillAlive() == 0 || enemyTeam->stillAlive() == 0) {
-                return;
-            }
-            if (!victim->isAlive()) {
-                victim = findClosestCharacter(leader->getLocation(), enemyTeam->getFighters());
-            }
-            if (!enemyTeam->leader->isAlive()) {
-                Point enemyLeaderLocation = enemyTeam->leader->getLocation();
-                Character *enemyNewLeader;
-                enemyNewLeader = findClosestCharacter(enemyLeaderLocation, this->getFighters());
-                enemyTeam->leader = enemyNewLeader;
+                if (proximity != nullptr && !victim->isAlive()) {
+                    proximity->changed(enemyTeam);
+                }
+                if (battleOver(enemyTeam)) {
+                    return;
+                }
+                if (!victim->isAlive()) {
+                    PROFILE_PHASE(VictimSearch);
+                    victim = nearest(leader->getLocation(), *enemyTeam, proximity);
+                }
+                reassignEnemyLeader(enemyTeam, proximity);
             }
         }
-        for (Character *attacker: fighters) {
-            if (attacker->isAlive() && victim->isAlive()) {
-                if (Ninja *ninja = dynamic_cast<Ninja *>(attacker)) {
-                    double distance = ninja->getLocation().distance(victim->getLocation());
-                    if (distance < 1) {
-                        ninja->slash(victim);
-                    } else {
-                        ninja->move(victim);
+        {
+            PROFILE_PHASE(NinjaPhase);
+            // Moves only change the position of the mover, so the moves toward one victim are batched and flushed
+            // before the victim changes or the attack ends, with the same result as moving one by one.
+            thread_local std::vector<Ninja *> movers;
+            movers.clear();
+            auto flush = [&] {
+                if (!movers.empty()) {
+                    Ninja::moveAll(movers, victim);
+                    if (proximity != nullptr) {
+                        proximity->changed(this);
+                        for (const Ninja *mover: movers) {
+                            proximity->moved(mover);
+                        }
                     }
+                    movers.clear();
                 }
+            };
+            for (Character *attacker: fighters) {
+                if (attacker->isAlive() && victim->isAlive()) {
+                    if (Ninja *ninja = dynamic_cast<Ninja *>(attacker)) {
+                        if (this->movement == Movement::Deterministic) {
+                            const FixedPoint position(ninja->getLocation());
+                            if (position.squaredDistance(FixedPoint(victim->getLocation())) <
+                                std::int64_t{FixedPoint::ONE} * FixedPoint::ONE) {
+                                ninja->slash(victim);
+                            } else {
+                                ninja->moveDeterministic(victim);
+                                if (proximity != nullptr) {
+                                    proximity->changed(this);
+                                    proximity->moved(ninja);
+                                }
+                            }
+                        } else {
+                            double distance = ninja->getLocation().distance(victim->getLocation());
+                            if (distance < 1) {
+                                ninja->slash(victim);
+                            } else {
+                                movers.push_back(ninja);
+                            }
+                        }
+                    }
+                }
+                if (proximity != nullptr && !victim->isAlive()) {
+                    proximity->changed(enemyTeam);
+                }
+                if (battleOver(enemyTeam)) {
+                    flush();
+                    return;
+                }
+                if (!victim->isAlive()) {
+                    flush();
+                    PROFILE_PHASE(VictimSearch);
+                    victim = nearest(leader->getLocation(), *enemyTeam, proximity);
+                }
+                reassignEnemyLeader(enemyTeam, proximity);
             }
-            if (this->stillAlive() == 0 || enemyTeam->stillAlive() == 0) {
-                return;
-            }
-            if (!victim->isAlive()) {
-                victim = findClosestCharacter(leader->getLocation(), enemyTeam->getFighters());
-            }
-            if (!enemyTeam->leader->isAlive()) {
-                Point enemyLeaderLocation = enemyTeam->leader->getLocation();
-                Character *enemyNewLeader;
-                enemyNewLeader = findClosestCharacter(enemyLeaderLocation, this->getFighters());
-                enemyTeam->leader = enemyNewLeader;
-            }
+            flush();
+        }
+    }
+
+/**
+* @brief Checks whether one of the teams was eliminated during an attack.
+* @param enemyTeam Pointer to the enemy team.
+* @return true if this team or the enemy team has no living members.
+*/
+    bool Team::battleOver(const Team *enemyTeam) const {
+        PROFILE_PHASE(LivenessCheck);
+        return this->stillAlive() == 0 || enemyTeam->stillAlive() == 0;
+    }
+
+/**
+* @brief Replaces the leader of the enemy team if it was killed.
+* @param enemyTeam Pointer to the enemy team.
+* @param proximity The cache of the battle, nullptr to search every time.
+*/
+    void Team::reassignEnemyLeader(Team *enemyTeam, ProximityCache *proximity) const {
+        if (!enemyTeam->leader->isAlive()) {
+            PROFILE_PHASE(EnemyLeaderReassignment);
+            Point enemyLeaderLocation = enemyTeam->leader->getLocation();
+            Character *enemyNewLeader;
+            enemyNewLeader = nearest(enemyLeaderLocation, *this, proximity);
+            enemyTeam->leader = enemyNewLeader;
         }
     }
 
@@ -167,6 +653,14 @@ namespace ariel {
 */
     int Team::stillAlive() const {
         int counter = 0;
+        if (!spatialOrder.empty()) {
+            for (const SpatialSlot &slot: spatialOrder) {
+                if (slot.fighter->isAlive()) {
+                    counter++;
+                }
+            }
+            return counter;
+        }
         for (Character *fighter: this->fighters) {
             if (fighter->isAlive()) {
                 counter++;
@@ -181,7 +675,7 @@ namespace ariel {
 */
     void Team::print() const {
         std::cout << "---------------------" << std::endl;
-        std::cout << "Team " << this->leader->getName() << std::endl;
+        std::cout << "Team " << (this->leader ? this->leader->getName() : "(moved)") << std::endl;
         std::cout << "---------------------" << std::endl;
         std::cout << "Team Status: " << (stillAlive() ? "Alive" : "Defeated") << std::endl;
         std::cout << "Number of Team members: " << (stillAlive() ? std::to_string(stillAlive()) : "0") << std::endl;
@@ -208,8 +702,189 @@ namespace ariel {
 * Frees the memory allocated to all the members (fighters) of the team.
 */
     Team::~Team() {
+        destroyFighters();
+    }
+
+/**
+* @brief Checks whether a fighter lives in the arena allocated by clone() or in the FighterArena of the team.
+*/
+    bool Team::inArena(const Character *fighter) const {
+        const auto *address = reinterpret_cast<const std::byte *>(fighter);
+        return arenaBase != nullptr && address >= arenaBase && address < arenaBase + arenaSize;
+    }
+
+/**
+* @brief Frees all the fighters, cloned fighters are destroyed in place and their arena released.
+*/
+    void Team::destroyFighters() {
         for (Character *fighter: fighters) {
-            delete fighter;
+            if (inArena(fighter)) {
+                fighter->~Character();
+            } else {
+                delete fighter;
+            }
+        }
+        fighters.clear();
+        spatialOrder.clear();
+        arena.reset();
+        arenaBase = nullptr;
+        arenaSize = 0;
+        if (index) {
+            index->invalidate();
+        }
+    }
+
+/**
+* @brief Swaps one fighter for a new one, used by TeamVariant to apply its overrides.
+* @param index Index of the fighter in insertion order.
+* @param fighter The new fighter, owned by the team from now on.
+* @throws std::invalid_argument If the fighter is null.
+* @throws std::runtime_error If the fighter is already in a team.
+*/
+    void Team::replaceFighter(std::size_t index, Character *fighter) {
+        if (!fighter) {
+            throw std::invalid_argument("Error: Invalid pointer to team fighter.");
+        }
+        if (fighter->isTeamMember()) {
+            throw std::runtime_error("Error: The character is already in some team.");
+        }
+        Character *old = fighters.at(index);
+        fighters[index] = fighter;
+        if (this->index) {
+            this->index->invalidate();
+        }
+        spatialOrder.clear();
+        fighter->setTeamMember(true);
+        if (this->leader == old) {
+            this->leader = fighter;
+        }
+        if (inArena(old)) {
+            old->~Character();
+        } else {
+            delete old;
+        }
+    }
+
+/**
+* @brief Total bytes of a team without the shared names: the team object, its fighter slots, its fighters and its
+* spatial index.
+*/
+    std::size_t MemoryUsage::total() const {
+        return team + fighterSlots + fighters + index;
+    }
+
+/**
+* @brief The count and bytes of the fighters of one kind.
+*/
+    const FighterTypeUsage &MemoryUsage::of(FighterKind kind) const {
+        return byType.at(static_cast<std::size_t>(kind));
+    }
+
+/**
+* @brief Accounts the bytes of this team, per component and per fighter kind.
+* @return The usage, byType bytes are the object sizes (without arena padding).
+*/
+    MemoryUsage Team::memoryUsage() const {
+        MemoryUsage usage;
+        usage.team = sizeof(Team);
+        usage.fighterSlots =
+                fighters.capacity() * sizeof(Character *) + spatialOrder.capacity() * sizeof(SpatialSlot);
+        // A FighterArena is shared with other teams, only this team's fighters in it are counted.
+        usage.fighters = arena ? arenaSize : 0;
+        usage.index = index ? index->bytes() : 0;
+        std::vector<NameId> names;
+        for (const Character *fighter: fighters) {
+            if (!arena || !inArena(fighter)) {
+                usage.fighters += fighter->footprint();
+            }
+            usage.vtablePointers += sizeof(void *);
+            FighterTypeUsage &type = usage.byType.at(static_cast<std::size_t>(fighter->kind()));
+            type.count++;
+            type.bytes += fighter->footprint();
+            if (std::find(names.begin(), names.end(), fighter->getNameId()) == names.end()) {
+                names.push_back(fighter->getNameId());
+                usage.names += NamePool::footprint(fighter->getNameId());
+            }
+        }
+        return usage;
+    }
+
+/**
+* @brief What memoryUsage().total() reports at most for a team of that many fighters, known before any is built.
+* Counts a slot of the largest kind per fighter and the vector grown by push_back, for a team in insertion layout
+* without a spatial index (the teams Protocol builds).
+* @param fighterCount The number of fighters, the leader included.
+*/
+    std::size_t Team::estimatedBytes(std::size_t fighterCount) {
+        std::size_t slots = 1;
+        while (slots < fighterCount) {
+            slots *= 2;
+        }
+        return sizeof(Team) + slots * sizeof(Character *) + fighterCount * FIGHTER_SLOT;
+    }
+
+/**
+* @brief Deep copies the team from this validated prototype.
+* All fighters are copy constructed into one allocation, the constructor and add() checks are not repeated.
+* @return A new team with the same fighters, leader and movement mode.
+* @throws std::runtime_error If this team has no leader (it was moved from).
+*/
+    Team Team::clone() const {
+        if (!this->leader) {
+            throw std::runtime_error("Error: Cannot clone a team without a leader.");
+        }
+        const std::size_t alignment = alignof(std::max_align_t);
+        std::size_t total = 0;
+        for (const Character *fighter: fighters) {
+            total += (fighter->footprint() + alignment - 1) / alignment * alignment;
+        }
+
+        Team copy;
+        copy.capacity = this->capacity;
+        copy.movement = this->movement;
+        copy.ranking = this->ranking;
+        copy.layout = this->layout;
+        if (index) {
+            copy.index = std::make_unique<TeamIndex>();
+        }
+        copy.arena = std::make_unique<std::byte[]>(total);
+        copy.arenaBase = copy.arena.get();
+        copy.arenaSize = total;
+        copy.fighters.reserve(fighters.size());
+        std::size_t offset = 0;
+        for (const Character *fighter: fighters) {
+            Character *clone = fighter->cloneInto(copy.arena.get() + offset);
+            clone->setTeamMember(true);
+            copy.fighters.push_back(clone);
+            if (fighter == this->leader) {
+                copy.leader = clone;
+            }
+            offset += (fighter->footprint() + alignment - 1) / alignment * alignment;
+        }
+        copy.relayout();
+        return copy;
+    }
+
+/**
+* @brief Deep copies the team and moves every fighter by a random offset, for randomized starts.
+* Each coordinate moves by a uniform offset in [-jitter, jitter], clamped to stay non negative.
+* @param jitter The largest offset along each axis.
+* @param random The random engine used for the offsets.
+* @return A new team with jittered positions.
+* @throws std::invalid_argument If jitter is negative.
+*/
+    Team Team::clone(double jitter, std::mt19937 &random) const {
+        if (jitter < 0) {
+            throw std::invalid_argument("Error: Jitter cannot be negative.");
+        }
+        Team copy = clone();
+        std::uniform_real_distribution<double> offset(-jitter, jitter);
+        for (Character *fighter: copy.fighters) {
+            Point location = fighter->getLocation();
+            double newX = std::max(0.0, location.getX() + offset(random));
+            double newY = std::max(0.0, location.getY() + offset(random));
+            fighter->setLocation(Point(newX, newY));
         }
+        return copy;
     }
 }
@@ -7,19 +7,147 @@
 
 #include "Point.hpp"
 #include "Character.hpp"
+#include "TeamIndex.hpp"
+#include "FighterArena.hpp"
 #include <vector>
 #include <algorithm>
+#include <array>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
 
 namespace ariel {
 
+    class ProximityCache;
+
+    enum class Movement {
+        // Double precision movement and distances, the classic rules.
+        FloatingPoint,
+        // 16.16 fixed point steps and integer distance comparisons, bit exact replays.
+        Deterministic
+    };
+
+    enum class Indexing {
+        // Every nearest query scans all the fighters, the fastest for the classic ten fighters.
+        LinearScan,
+        // Nearest queries on this team's fighters go through a TeamIndex, for large rosters.
+        Spatial
+    };
+
+    enum class Ranking {
+        // Victims and leaders are ranked by Point::distance, the classic rules.
+        Exact,
+        // Ranked by Point::approximateDistance in linear scans, for mass battles. Enemies with a spatial index are
+        // still searched exactly, and slash ranges and moves always use the exact distance.
+        Approximate,
+        // Like Approximate, and every approximate scan is repeated exactly to count in getRankingStats() how often
+        // the pick differs.
+        Audited
+    };
+
+    // How often Ranking::Audited picked a different fighter than the exact ranking would have.
+    struct RankingStats {
+        std::size_t queries = 0;
+        std::size_t mismatches = 0;
+    };
+
+    enum class Layout {
+        // Fighters stay where they were allocated.
+        Insertion,
+        // relayout() packs the fighters into one arena in Z-order (Morton order) of their locations, so fighters
+        // near each other on the board are near each other in memory. The turn order does not change.
+        Morton
+    };
+
+    struct FighterTypeUsage {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+    };
+
+    // Bytes owned by a team. Heap sizes are the requested sizes, allocator headers are not included.
+    struct MemoryUsage {
+        std::size_t team = 0;
+        // Capacity of the fighter pointer vector.
+        std::size_t fighterSlots = 0;
+        // Fighter objects, vtable pointers included. For cloned teams the whole arena, padding included.
+        std::size_t fighters = 0;
+        // The part of fighters taken by vtable pointers.
+        std::size_t vtablePointers = 0;
+        // The spatial index, when the team has one.
+        std::size_t index = 0;
+        // Interned names of the fighters. Names are shared by every team using them, so total() leaves them out.
+        std::size_t names = 0;
+        std::array<FighterTypeUsage, static_cast<std::size_t>(FighterKind::Count)> byType{};
+
+        std::size_t total() const;
+
+        const FighterTypeUsage &of(FighterKind kind) const;
+    };
+
     class Team {
     private:
         Character *leader;
         std::vector<Character *> fighters;
+        std::size_t capacity;
+        Movement movement;
+        Ranking ranking;
+        // Counted by the const nearest queries.
+        mutable RankingStats rankingStats;
+        // Heap allocated so the fighters' observer pointer survives moves of the team.
+        std::unique_ptr<TeamIndex> index;
+        // Fighters created by clone() share one allocation, they are destroyed in place instead of deleted.
+        std::unique_ptr<std::byte[]> arena;
+        // Where the fighters destroyed in place live: arena, or the memory of a FighterArena the team was built on.
+        std::byte *arenaBase;
+        std::size_t arenaSize;
+        Layout layout;
+
+        // A fighter in memory order with its position in fighters, the turn order.
+        struct SpatialSlot {
+            Character *fighter;
+            std::uint32_t turn;
+        };
+
+        // The fighters in arena order after relayout(), empty when they are not laid out. Scans whose order does
+        // not matter, or that break ties by turn, walk this instead of fighters to read memory in sequence.
+        std::vector<SpatialSlot> spatialOrder;
+
+        Team();
+
+        bool inArena(const Character *fighter) const;
+
+        void destroyFighters();
+
+        void replaceFighter(std::size_t index, Character *fighter);
+
+        friend class TeamVariant;
+
+        Character *nearest(const Point &location, const Team &owner) const;
+
+        Character *approximateNearest(const Point &location, const Team &owner) const;
+
+        Character *nearest(const Point &location, const Team &owner, ProximityCache *proximity) const;
+
+        template<typename Collector>
+        void collect(const Point &location, Collector &collector) const;
+
+        bool battleOver(const Team *enemyTeam) const;
+
+        void reassignEnemyLeader(Team *enemyTeam, ProximityCache *proximity) const;
 
     public:
-        Team(Character *leader);
+        static constexpr std::size_t DEFAULT_CAPACITY = 10;
+        // The room any fighter kind takes in a FighterArena: the largest kind, rounded up to the arena alignment.
+        static constexpr std::size_t FIGHTER_SLOT =
+                (std::max({sizeof(Cowboy), sizeof(YoungNinja), sizeof(TrainedNinja), sizeof(OldNinja)}) +
+                 alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        Team(Character *leader, std::size_t capacity = DEFAULT_CAPACITY);
+
+        // A team whose fighters, the leader included, are constructed in arena.
+        Team(Character *leader, FighterArena &arena, std::size_t capacity = DEFAULT_CAPACITY);
 
         Character *getLeader() const;
 
@@ -31,22 +159,84 @@ namespace ariel {
 
         Character *findClosestCharacter(const Point &location, const std::vector<Character *> &fighters) const;
 
+        // Calls visitor(Character *fighter, double distance) for each living fighter at most radius away, in no
+        // particular order.
+        template<typename Visitor>
+        void withinRadius(const Point &location, double radius, Visitor &&visitor) const;
+
+        // The living fighter of owner this team would target from location, by its movement and ranking modes.
+        Character *pickTarget(const Point &location, const Team &owner) const;
+
+        // Writes the living fighters nearest to location into hits, nearest first, k is the size of hits.
+        std::size_t kNearest(const Point &location, std::span<NearestHit> hits) const;
+
+        std::size_t getCapacity() const;
+
+        Indexing getIndexing() const;
+
+        void setIndexing(Indexing newIndexing);
+
+        Movement getMovement() const;
+
+        void setMovement(Movement newMovement);
+
+        Ranking getRanking() const;
+
+        void setRanking(Ranking newRanking);
+
+        RankingStats getRankingStats() const;
+
+        Layout getLayout() const;
+
+        void setLayout(Layout newLayout);
+
+        void relayout(Team *enemyTeam = nullptr);
+
         void attack(Team *enemyTeam);
 
+        // Shares nearest query answers with the other attacks of a battle, nullptr shares nothing.
+        void attack(Team *enemyTeam, ProximityCache *proximity);
+
         int stillAlive() const;
 
         void print() const;
 
+        MemoryUsage memoryUsage() const;
+
+        static std::size_t estimatedBytes(std::size_t fighterCount);
+
+        Team clone() const;
+
+        Team clone(double jitter, std::mt19937 &random) const;
+
         // Make tidy make me write this
         Team(const Team &) = delete;
 
         Team &operator=(const Team &) = delete;
 
-        Team(Team &&) = delete;
+        // Moves transfer the fighters and the leader, the moved from team is left empty
+        Team(Team &&other) noexcept;
 
-        Team &operator=(Team &&) = delete;
+        Team &operator=(Team &&other) noexcept;
     };
 
+/**
+ * @brief Visits the living fighters within a radius of a location, through the spatial index when there is one.
+ * Nothing is allocated, the visitor is called in place. The fighters must not be moved or hit while visited.
+ * @param location The center of the search.
+ * @param radius The largest distance visited, edges included.
+ * @param visitor Called with each fighter and its distance from location.
+ * @throws std::invalid_argument If the radius is negative.
+ */
+    template<typename Visitor>
+    void Team::withinRadius(const Point &location, double radius, Visitor &&visitor) const {
+        if (!(radius >= 0)) {
+            throw std::invalid_argument("Error: The radius cannot be negative.");
+        }
+        RadiusQuery query(radius, visitor);
+        collect(location, query);
+    }
+
 }
 
 #endif //COWBOY_VS_NINJA_A_TEAM_HPP
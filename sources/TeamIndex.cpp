@@ -0,0 +1,125 @@
+/**
+ * @file TeamIndex.cpp
+ * @brief Implements the spatial index of a team.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "TeamIndex.hpp"
+
+namespace ariel {
+
+/**
+ * @brief Constructs an empty index, built by the first query.
+ */
+    TeamIndex::TeamIndex() : stale(true) {}
+
+/**
+ * @brief Marks the index out of date, after fighters were added or replaced.
+ */
+    void TeamIndex::invalidate() {
+        stale = true;
+    }
+
+/**
+ * @brief Stops observing the fighters, before the index is destroyed while they live on.
+ */
+    void TeamIndex::detach(const std::vector<Character *> &fighters) {
+        for (Character *fighter: fighters) {
+            fighter->setObserver(nullptr);
+        }
+    }
+
+/**
+ * @brief Called when an observed fighter moves. A moved cowboy makes the k-d tree stale, a ninja is moved in the
+ * quadtree. A quadtree with too many ninjas outside its leaves is rebuilt by the next query.
+ */
+    void TeamIndex::moved(Character *fighter, const Point &/*from*/) {
+        if (stale) {
+            return;
+        }
+        if (fighter->kind() == FighterKind::Cowboy) {
+            stale = true;
+            return;
+        }
+        ninjas.moved(fighter);
+        if (ninjas.degraded()) {
+            stale = true;
+        }
+    }
+
+/**
+ * @brief Called when an observed fighter dies or is revived. Dead cowboys stay in the k-d tree, which skips them.
+ */
+    void TeamIndex::aliveChanged(Character *fighter) {
+        if (!stale && fighter->kind() != FighterKind::Cowboy) {
+            ninjas.aliveChanged(fighter);
+        }
+    }
+
+/**
+ * @brief Rebuilds the index from the fighters of the team and starts observing them.
+ * @param fighters The fighters of the team, in team order.
+ */
+    void TeamIndex::rebuild(const std::vector<Character *> &fighters) {
+        std::vector<IndexedFighter> cowboyNodes;
+        std::vector<IndexedFighter> ninjaNodes;
+        for (std::size_t order = 0; order < fighters.size(); order++) {
+            Character *fighter = fighters[order];
+            fighter->setObserver(this);
+            IndexedFighter node{fighter->getLocation(), fighter, static_cast<std::uint32_t>(order)};
+            if (fighter->kind() == FighterKind::Cowboy) {
+                cowboyNodes.push_back(node);
+            } else {
+                ninjaNodes.push_back(node);
+            }
+        }
+        cowboys.build(std::move(cowboyNodes));
+        ninjas.build(ninjaNodes);
+        stale = false;
+    }
+
+/**
+ * @brief The nearest living fighter, the same one Team::findClosestCharacter finds by a linear scan.
+ * @param origin The location to search from.
+ * @param fighters The fighters of the team, used when the index has to be rebuilt.
+ * @return The fighter, nullptr if none is alive.
+ */
+    Character *TeamIndex::nearest(const Point &origin, const std::vector<Character *> &fighters) {
+        NearestCandidate best;
+        collect(origin, fighters, best);
+        return best.fighter;
+    }
+
+/**
+ * @brief Offers the living fighters of the team to a collector, the cowboys first, then the ninjas.
+ * @param origin The location to search from.
+ * @param fighters The fighters of the team, used when the index has to be rebuilt.
+ * @param collector The answers so far, updated in place.
+ */
+    template<typename Collector>
+    void TeamIndex::collect(const Point &origin, const std::vector<Character *> &fighters, Collector &collector) {
+        if (stale) {
+            rebuild(fighters);
+        }
+        cowboys.collect(origin, collector);
+        ninjas.collect(origin, collector);
+    }
+
+    template void TeamIndex::collect(const Point &origin, const std::vector<Character *> &fighters,
+                                     NearestCandidate &collector);
+
+    template void TeamIndex::collect(const Point &origin, const std::vector<Character *> &fighters,
+                                     NearestHits &collector);
+
+    template void TeamIndex::collect(const Point &origin, const std::vector<Character *> &fighters,
+                                     RadiusQuery &collector);
+
+/**
+ * @brief Bytes held by the index.
+ */
+    std::size_t TeamIndex::bytes() const {
+        return sizeof(TeamIndex) - sizeof(LooseQuadtree) + cowboys.bytes() + ninjas.bytes();
+    }
+
+}
@@ -0,0 +1,50 @@
+/**
+ * @file TeamIndex.hpp
+ * @brief Spatial index of the fighters of one team, for nearest living fighter queries on large rosters.
+ * The cowboys, which never move on their own, are kept in a static k-d tree, the ninjas in a loose quadtree.
+ * The index observes its fighters: moving a cowboy marks the k-d tree stale and it is rebuilt by the next query,
+ * moves and deaths of ninjas update the quadtree in place.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_TEAMINDEX_HPP
+#define COWBOY_VS_NINJA_A_TEAMINDEX_HPP
+
+#include "KdTree.hpp"
+#include "LooseQuadtree.hpp"
+#include <vector>
+
+namespace ariel {
+
+    class TeamIndex : public FighterObserver {
+    private:
+        KdTree cowboys;
+        LooseQuadtree ninjas;
+        bool stale;
+
+        void rebuild(const std::vector<Character *> &fighters);
+
+    public:
+        TeamIndex();
+
+        void invalidate();
+
+        void detach(const std::vector<Character *> &fighters);
+
+        void moved(Character *fighter, const Point &from) override;
+
+        void aliveChanged(Character *fighter) override;
+
+        Character *nearest(const Point &origin, const std::vector<Character *> &fighters);
+
+        // Collector is NearestCandidate, NearestHits or RadiusQuery.
+        template<typename Collector>
+        void collect(const Point &origin, const std::vector<Character *> &fighters, Collector &collector);
+
+        std::size_t bytes() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_TEAMINDEX_HPP
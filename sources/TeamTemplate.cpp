@@ -0,0 +1,155 @@
+/**
+ * @file TeamTemplate.cpp
+ * @brief Implements the shared team template and its sparse copy on write variants.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "TeamTemplate.hpp"
+
+namespace ariel {
+
+/**
+ * @brief Freezes a team as a template, the team must not be used directly afterwards.
+ * @param prototype The validated roster, moved into the template.
+ * @throws std::invalid_argument If the prototype has no leader (it was moved from).
+ */
+    TeamTemplate::TeamTemplate(Team &&prototype) {
+        if (!prototype.getLeader()) {
+            throw std::invalid_argument("Error: Template needs a team with a leader.");
+        }
+        base = std::make_shared<const Team>(std::move(prototype));
+    }
+
+/**
+ * @brief The frozen roster shared by all variants.
+ */
+    const Team &TeamTemplate::prototype() const {
+        return *base;
+    }
+
+/**
+ * @brief Creates a variant that shares all the fighters of the template.
+ */
+    TeamVariant TeamTemplate::variant() const {
+        return TeamVariant(base);
+    }
+
+/**
+ * @brief Constructs a variant without any override.
+ * @param base The shared roster.
+ * @throws std::invalid_argument If base is null.
+ */
+    TeamVariant::TeamVariant(std::shared_ptr<const Team> base) : base(std::move(base)) {
+        if (!this->base) {
+            throw std::invalid_argument("Error: Invalid team template.");
+        }
+    }
+
+/**
+ * @brief Number of fighters in the variant.
+ */
+    std::size_t TeamVariant::size() const {
+        return base->getFighters().size();
+    }
+
+/**
+ * @brief Number of fighters this variant changes, the only per variant memory besides the shared pointer.
+ */
+    std::size_t TeamVariant::overrideCount() const {
+        return overrides.size();
+    }
+
+/**
+ * @brief The override of a fighter, created on the first write.
+ * @throws std::out_of_range If index is not a fighter of the template.
+ */
+    TeamVariant::Override &TeamVariant::overrideAt(std::size_t index) {
+        if (index >= size()) {
+            throw std::out_of_range("Error: Fighter index out of range.");
+        }
+        for (Override &existing: overrides) {
+            if (existing.index == index) {
+                return existing;
+            }
+        }
+        overrides.push_back(Override{index, std::nullopt, nullptr});
+        return overrides.back();
+    }
+
+/**
+ * @brief The override of a fighter, nullptr if the fighter is still shared.
+ */
+    const TeamVariant::Override *TeamVariant::findOverride(std::size_t index) const {
+        for (const Override &existing: overrides) {
+            if (existing.index == index) {
+                return &existing;
+            }
+        }
+        return nullptr;
+    }
+
+/**
+ * @brief Moves one fighter of the variant, the template is not touched.
+ * @param index Index of the fighter in insertion order.
+ * @param location The new starting location.
+ * @throws std::out_of_range If index is not a fighter of the template.
+ * @throws std::invalid_argument If the location has a negative coordinate.
+ */
+    void TeamVariant::setLocation(std::size_t index, const Point &location) {
+        if (location.getX() < 0.0 || location.getY() < 0.0) {
+            throw std::invalid_argument("Error: Location coordinates cannot be negative.");
+        }
+        overrideAt(index).location = location;
+    }
+
+/**
+ * @brief Replaces one fighter of the variant, for example to change its type.
+ * The factory is called on every materialize and must return a new fighter that is not in any team.
+ * A location set with setLocation for the same index is applied on top of the new fighter.
+ * @param index Index of the fighter in insertion order.
+ * @param fighter Builds the replacement fighter.
+ * @throws std::out_of_range If index is not a fighter of the template.
+ * @throws std::invalid_argument If the factory is empty.
+ */
+    void TeamVariant::replace(std::size_t index, FighterFactory fighter) {
+        if (!fighter) {
+            throw std::invalid_argument("Error: Invalid fighter factory.");
+        }
+        overrideAt(index).replacement = std::move(fighter);
+    }
+
+/**
+ * @brief Starting location of a fighter as seen by this variant.
+ * @param index Index of the fighter in insertion order.
+ * @return The overridden location, otherwise the location of the shared fighter.
+ * @throws std::out_of_range If index is not a fighter of the template.
+ */
+    Point TeamVariant::location(std::size_t index) const {
+        const Override *changed = findOverride(index);
+        if (changed && changed->location) {
+            return *changed->location;
+        }
+        return base->getFighters().at(index)->getLocation();
+    }
+
+/**
+ * @brief Copies the variant into a real team that can fight: a clone of the template with the overrides applied.
+ * @return The team.
+ * @throws std::invalid_argument If a replacement factory returns null.
+ * @throws std::runtime_error If a replacement factory returns a fighter that is already in a team.
+ */
+    Team TeamVariant::materialize() const {
+        Team team = base->clone();
+        for (const Override &changed: overrides) {
+            if (changed.replacement) {
+                team.replaceFighter(changed.index, changed.replacement());
+            }
+            if (changed.location) {
+                team.fighters[changed.index]->setLocation(*changed.location);
+            }
+        }
+        return team;
+    }
+
+}
@@ -0,0 +1,72 @@
+/**
+ * @file TeamTemplate.hpp
+ * @brief Copy on write team templates for scenario sweeps.
+ * A TeamTemplate freezes a validated roster. Its variants share the frozen fighters and only record the
+ * positions and fighters they change, so thousands of variants cost a few bytes each. A variant becomes a real
+ * Team (a clone of the template plus its overrides) only when it is about to fight, when fighters get hit or move.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_TEAMTEMPLATE_HPP
+#define COWBOY_VS_NINJA_A_TEAMTEMPLATE_HPP
+
+#include "Team.hpp"
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace ariel {
+
+    class TeamVariant;
+
+    class TeamTemplate {
+    private:
+        std::shared_ptr<const Team> base;
+
+    public:
+        explicit TeamTemplate(Team &&prototype);
+
+        const Team &prototype() const;
+
+        TeamVariant variant() const;
+    };
+
+    class TeamVariant {
+    public:
+        using FighterFactory = std::function<Character *()>;
+
+    private:
+        struct Override {
+            std::size_t index;
+            std::optional<Point> location;
+            FighterFactory replacement;
+        };
+
+        std::shared_ptr<const Team> base;
+        std::vector<Override> overrides;
+
+        Override &overrideAt(std::size_t index);
+
+        const Override *findOverride(std::size_t index) const;
+
+    public:
+        explicit TeamVariant(std::shared_ptr<const Team> base);
+
+        std::size_t size() const;
+
+        std::size_t overrideCount() const;
+
+        void setLocation(std::size_t index, const Point &location);
+
+        void replace(std::size_t index, FighterFactory fighter);
+
+        Point location(std::size_t index) const;
+
+        Team materialize() const;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_TEAMTEMPLATE_HPP
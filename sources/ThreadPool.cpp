@@ -0,0 +1,246 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implements the work stealing thread pool.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ariel {
+
+    namespace {
+        // Index of the pool worker running on this thread, used to push follow up tasks locally.
+        thread_local const void *currentPool = nullptr;
+        thread_local std::size_t currentWorker = 0;
+    }
+
+/**
+ * @brief Starts the worker threads.
+ * @param threadCount Number of workers, 0 means one worker per hardware thread.
+ */
+    ThreadPool::ThreadPool(std::size_t threadCount) : queued(0), pending(0), nextWorker(0), stopping(false) {
+        if (threadCount == 0) {
+            threadCount = std::max(1U, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 0; i < threadCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (std::size_t i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+/**
+ * @brief Waits for the queued tasks to finish and joins the workers.
+ */
+    ThreadPool::~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> guard(sleepLock);
+            allDone.wait(guard, [this] { return pending.load() == 0; });
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (std::thread &thread: threads) {
+            thread.join();
+        }
+    }
+
+/**
+ * @brief Getter for the number of workers.
+ * @return The number of worker threads.
+ */
+    std::size_t ThreadPool::size() const {
+        return this->workers.size();
+    }
+
+/**
+ * @brief Queues a task. From a worker thread the task goes to that worker's own deque, otherwise round robin.
+ * @param task The task to run, it must not throw. Use a TaskGroup to get a task's exception back.
+ * @throws std::invalid_argument If the task is empty.
+ */
+    void ThreadPool::submit(Task task) {
+        if (!task) {
+            throw std::invalid_argument("Error: Cannot submit an empty task.");
+        }
+        std::size_t index = (currentPool == this) ? currentWorker : nextWorker++ % workers.size();
+        pending++;
+        {
+            std::lock_guard<std::mutex> guard(workers[index]->lock);
+            workers[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            queued++;
+        }
+        wakeUp.notify_one();
+    }
+
+/**
+ * @brief Takes the newest task of the worker's own deque.
+ */
+    bool ThreadPool::popOwn(std::size_t index, Task &task) {
+        std::lock_guard<std::mutex> guard(workers[index]->lock);
+        if (workers[index]->tasks.empty()) {
+            return false;
+        }
+        task = std::move(workers[index]->tasks.back());
+        workers[index]->tasks.pop_back();
+        return true;
+    }
+
+/**
+ * @brief Takes the oldest task of another worker's deque.
+ */
+    bool ThreadPool::steal(std::size_t index, Task &task) {
+        for (std::size_t offset = 1; offset < workers.size(); offset++) {
+            Worker &victim = *workers[(index + offset) % workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+/**
+ * @brief Marks one task as finished and wakes up waiters when it was the last one.
+ */
+    void ThreadPool::finishTask() {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        if (--pending == 0) {
+            allDone.notify_all();
+        }
+    }
+
+/**
+ * @brief Runs a task whose queued count was already claimed and marks it as finished.
+ */
+    void ThreadPool::runClaimed(std::size_t index) {
+        Task task;
+        // every claimed task is already pushed, but other workers may take it during the scan, so retry
+        while (!popOwn(index, task) && !steal(index, task)) {
+            std::this_thread::yield();
+        }
+        task();
+        finishTask();
+    }
+
+/**
+ * @brief Runs one queued task on the calling worker, used by a worker waiting for a TaskGroup.
+ * @return false If no task was queued.
+ */
+    bool ThreadPool::runQueued() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            if (queued.load() == 0) {
+                return false;
+            }
+            queued--;
+        }
+        runClaimed(currentWorker);
+        return true;
+    }
+
+/**
+ * @brief Main loop of a worker: run own tasks, steal when empty, sleep when there is nothing to steal.
+ */
+    void ThreadPool::workerLoop(std::size_t index) {
+        currentPool = this;
+        currentWorker = index;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(sleepLock);
+                wakeUp.wait(guard, [this] { return stopping || queued.load() > 0; });
+                if (queued.load() == 0) {
+                    return;
+                }
+                queued--;
+            }
+            runClaimed(index);
+        }
+    }
+
+/**
+ * @brief Constructs an empty group of tasks on the pool.
+ * @param pool The pool running the tasks, it must outlive the group.
+ */
+    ThreadPool::TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool), pending(0) {}
+
+/**
+ * @brief Waits for the tasks of the group, their exceptions are dropped.
+ */
+    ThreadPool::TaskGroup::~TaskGroup() {
+        try {
+            wait();
+        } catch (...) {
+        }
+    }
+
+/**
+ * @brief Queues a task of the group on the pool.
+ * @param task The task to run, its exception is kept for wait.
+ * @throws std::invalid_argument If the task is empty.
+ */
+    void ThreadPool::TaskGroup::submit(Task task) {
+        if (!task) {
+            throw std::invalid_argument("Error: Cannot submit an empty task.");
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pending++;
+        }
+        pool.submit([this, task = std::move(task)] {
+            std::exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            finishTask(error);
+        });
+    }
+
+/**
+ * @brief Marks one task of the group as finished, keeping its exception when it is the first one.
+ */
+    void ThreadPool::TaskGroup::finishTask(std::exception_ptr error) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (error && !firstError) {
+            firstError = error;
+        }
+        if (--pending == 0) {
+            allDone.notify_all();
+        }
+    }
+
+/**
+ * @brief Blocks until every task of the group finished. On a worker of the pool it runs queued tasks meanwhile,
+ * so a task may wait for a group of its own without starving the pool.
+ * @throws The first exception thrown by a task of the group since the last wait.
+ */
+    void ThreadPool::TaskGroup::wait() {
+        std::unique_lock<std::mutex> guard(lock);
+        if (currentPool == &pool) {
+            while (pending != 0) {
+                guard.unlock();
+                if (!pool.runQueued()) {
+                    std::this_thread::yield();
+                }
+                guard.lock();
+            }
+        } else {
+            allDone.wait(guard, [this] { return pending == 0; });
+        }
+        if (firstError) {
+            std::exception_ptr error = firstError;
+            firstError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+}
@@ -0,0 +1,112 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief A fixed size thread pool with a task deque per worker and work stealing between workers.
+ * Tasks submitted from a worker go to the back of its own deque, idle workers steal from the front of other deques.
+ * Callers wait for their own tasks through a TaskGroup, never for the whole pool.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_THREADPOOL_HPP
+#define COWBOY_VS_NINJA_A_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ariel {
+
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        struct Worker {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+        std::condition_variable allDone;
+        std::atomic<std::size_t> queued;
+        std::atomic<std::size_t> pending;
+        std::atomic<std::size_t> nextWorker;
+        bool stopping;
+
+        void workerLoop(std::size_t index);
+
+        bool popOwn(std::size_t index, Task &task);
+
+        bool steal(std::size_t index, Task &task);
+
+        void finishTask();
+
+        void runClaimed(std::size_t index);
+
+        bool runQueued();
+
+    public:
+        class TaskGroup;
+
+        explicit ThreadPool(std::size_t threadCount = 0);
+
+        ~ThreadPool();
+
+        std::size_t size() const;
+
+        void submit(Task task);
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ThreadPool(ThreadPool &&) = delete;
+
+        ThreadPool &operator=(ThreadPool &&) = delete;
+    };
+
+    /**
+     * @brief The tasks of one caller on a shared pool. wait only waits for these tasks and only rethrows their
+     * exceptions, so callers sharing a pool do not see each other's work. Waiting on a worker of the pool runs
+     * queued tasks meanwhile instead of blocking the worker.
+     */
+    class ThreadPool::TaskGroup {
+    private:
+        ThreadPool &pool;
+        std::mutex lock;
+        std::condition_variable allDone;
+        std::size_t pending;
+        std::exception_ptr firstError;
+
+        void finishTask(std::exception_ptr error);
+
+    public:
+        explicit TaskGroup(ThreadPool &pool);
+
+        ~TaskGroup();
+
+        void submit(Task task);
+
+        void wait();
+
+        TaskGroup(const TaskGroup &) = delete;
+
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        TaskGroup(TaskGroup &&) = delete;
+
+        TaskGroup &operator=(TaskGroup &&) = delete;
+    };
+
+}
+
+#endif //COWBOY_VS_NINJA_A_THREADPOOL_HPP
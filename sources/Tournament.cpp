@@ -0,0 +1,92 @@
+/**
+ * @file Tournament.cpp
+ * @brief Schedules every ordered matchup, K times, as an independent task so long battles do not stall the others.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "Tournament.hpp"
+
+namespace ariel {
+
+/**
+ * @brief Win rate of one team against another.
+ * @param first The team attacking first.
+ * @param second The team attacking second.
+ * @return The fraction of the battles won by first, 0 if no battle was played.
+ */
+    double TournamentResult::winRate(std::size_t first, std::size_t second) const {
+        int played = battles.at(first).at(second);
+        if (played == 0) {
+            return 0;
+        }
+        return static_cast<double>(wins[first][second]) / played;
+    }
+
+/**
+ * @brief Plays all N*(N-1) ordered matchups, options.repetitions times each.
+ * Every battle is its own task, each task writes only its own outcome slot so no locking is needed.
+ * @param factories The team designs taking part.
+ * @param options Number of repetitions and the options of every battle.
+ * @param pool The pool that plays the battles.
+ * @return The win and battle counts matrices.
+ * @throws std::invalid_argument If a factory is empty or the repetitions are negative.
+ * @throws Any exception thrown by a factory or a battle.
+ */
+    TournamentResult runTournament(const std::vector<TeamFactory> &factories, const TournamentOptions &options,
+                                   ThreadPool &pool) {
+        if (options.repetitions < 0) {
+            throw std::invalid_argument("Error: Repetitions cannot be negative.");
+        }
+        for (const TeamFactory &factory: factories) {
+            if (!factory) {
+                throw std::invalid_argument("Error: Invalid team factory.");
+            }
+        }
+        const std::size_t teams = factories.size();
+        const auto repetitions = static_cast<std::size_t>(options.repetitions);
+
+        struct Matchup {
+            std::size_t first;
+            std::size_t second;
+        };
+        std::vector<Matchup> matchups;
+        for (std::size_t first = 0; first < teams; first++) {
+            for (std::size_t second = 0; second < teams; second++) {
+                if (first != second) {
+                    for (std::size_t rep = 0; rep < repetitions; rep++) {
+                        matchups.push_back({first, second});
+                    }
+                }
+            }
+        }
+
+        std::vector<BattleWinner> outcomes(matchups.size(), BattleWinner::None);
+        ThreadPool::TaskGroup battles(pool);
+        for (std::size_t index = 0; index < matchups.size(); index++) {
+            battles.submit([&factories, &options, &matchups, &outcomes, index] {
+                Team teamA = factories[matchups[index].first]();
+                Team teamB = factories[matchups[index].second]();
+                BattleResult result = runBattle(teamA, teamB, options.battle);
+                outcomes[index] = result.winner;
+                if (options.results != nullptr) {
+                    options.results->record(result);
+                }
+            });
+        }
+        battles.wait();
+
+        TournamentResult result;
+        result.wins.assign(teams, std::vector<int>(teams, 0));
+        result.battles.assign(teams, std::vector<int>(teams, 0));
+        for (std::size_t index = 0; index < matchups.size(); index++) {
+            const Matchup &matchup = matchups[index];
+            result.battles[matchup.first][matchup.second]++;
+            if (outcomes[index] == BattleWinner::TeamA) {
+                result.wins[matchup.first][matchup.second]++;
+            }
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,44 @@
+/**
+ * @file Tournament.hpp
+ * @brief Round robin tournament between team designs, played on a work stealing thread pool.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_TOURNAMENT_HPP
+#define COWBOY_VS_NINJA_A_TOURNAMENT_HPP
+
+#include "Battle.hpp"
+#include "ThreadPool.hpp"
+#include "ResultsAggregator.hpp"
+#include <functional>
+#include <vector>
+
+namespace ariel {
+
+    // Builds a fresh roster for every battle, teams own their fighters and are consumed by the battle.
+    using TeamFactory = std::function<Team()>;
+
+    struct TournamentOptions {
+        // Number of battles played for every ordered pair of teams.
+        int repetitions = 1;
+        BattleOptions battle;
+        // Optional tally that receives every battle result as soon as it finishes.
+        ResultsAggregator *results = nullptr;
+    };
+
+    struct TournamentResult {
+        // wins[i][j] - battles team i won when attacking first against team j.
+        std::vector<std::vector<int>> wins;
+        // battles[i][j] - battles played with team i attacking first against team j.
+        std::vector<std::vector<int>> battles;
+
+        double winRate(std::size_t first, std::size_t second) const;
+    };
+
+    TournamentResult runTournament(const std::vector<TeamFactory> &factories, const TournamentOptions &options,
+                                   ThreadPool &pool);
+
+}
+
+#endif //COWBOY_VS_NINJA_A_TOURNAMENT_HPP
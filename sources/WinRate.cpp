@@ -0,0 +1,146 @@
+/**
+ * @file WinRate.cpp
+ * @brief Plays battles in batches and stops as soon as the requested stopping rule is satisfied.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#include "WinRate.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ariel {
+
+    namespace {
+
+        /**
+         * @brief Two sided normal quantile, found by bisection on erfc.
+         * @param confidence The confidence level in (0, 1).
+         * @return z such that P(|Z| <= z) == confidence.
+         */
+        double normalQuantile(double confidence) {
+            double low = 0;
+            double high = 40;
+            for (int i = 0; i < 100; i++) {
+                double middle = (low + high) / 2;
+                if (std::erfc(middle / std::sqrt(2.0)) > 1 - confidence) {
+                    low = middle;
+                } else {
+                    high = middle;
+                }
+            }
+            return (low + high) / 2;
+        }
+
+        /**
+         * @brief Updates the Wilson score interval of the estimate.
+         */
+        void wilsonInterval(WinRateEstimate &estimate, double z) {
+            double n = estimate.battles;
+            double p = estimate.winRate;
+            double denominator = 1 + z * z / n;
+            double center = (p + z * z / (2 * n)) / denominator;
+            double margin = z * std::sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / denominator;
+            estimate.lower = std::max(0.0, center - margin);
+            estimate.upper = std::min(1.0, center + margin);
+        }
+
+        /**
+         * @brief Checks the options before any battle is played.
+         * @throws std::invalid_argument If one of the options is out of its range.
+         */
+        void validate(const WinRateOptions &options) {
+            if (options.maxBattles < 1 || options.minBattles < 0 || options.batchSize < 1) {
+                throw std::invalid_argument("Error: Battle counts must be positive.");
+            }
+            if (options.confidence <= 0 || options.confidence >= 1 || options.halfWidth <= 0) {
+                throw std::invalid_argument("Error: Invalid confidence interval target.");
+            }
+            if (options.p0 <= 0 || options.p1 >= 1 || options.p0 >= options.p1) {
+                throw std::invalid_argument("Error: SPRT needs 0 < p0 < p1 < 1.");
+            }
+            if (options.alpha <= 0 || options.alpha >= 1 || options.beta <= 0 || options.beta >= 1) {
+                throw std::invalid_argument("Error: SPRT error rates must be in (0, 1).");
+            }
+        }
+    }
+
+/**
+ * @brief Estimates the probability that teamA (attacking first) beats teamB.
+ * Battles are played in batches, on the pool when one is given, and after every batch the stopping rule is checked.
+ * Unfinished battles (round limit reached) count as losses of teamA.
+ * @param teamA Builds the team attacking first.
+ * @param teamB Builds the team attacking second.
+ * @param options The stopping rule and its parameters.
+ * @param pool Optional pool to play each batch in parallel.
+ * @return The estimate, its confidence interval, the SPRT decision and the number of battles saved.
+ * @throws std::invalid_argument If a factory is empty or the options are invalid.
+ */
+    WinRateEstimate estimateWinRate(const TeamFactory &teamA, const TeamFactory &teamB, const WinRateOptions &options,
+                                    ThreadPool *pool) {
+        if (!teamA || !teamB) {
+            throw std::invalid_argument("Error: Invalid team factory.");
+        }
+        validate(options);
+        const double z = normalQuantile(options.confidence);
+        const double upperBound = std::log((1 - options.beta) / options.alpha);
+        const double lowerBound = std::log(options.beta / (1 - options.alpha));
+        const double winStep = std::log(options.p1 / options.p0);
+        const double lossStep = std::log((1 - options.p1) / (1 - options.p0));
+
+        WinRateEstimate estimate;
+        std::vector<BattleWinner> batch;
+        auto playOne = [&teamA, &teamB, &options](BattleWinner &outcome) {
+            Team first = teamA();
+            Team second = teamB();
+            outcome = runBattle(first, second, options.battle).winner;
+        };
+
+        while (estimate.battles < options.maxBattles) {
+            batch.assign(static_cast<std::size_t>(std::min(options.batchSize, options.maxBattles - estimate.battles)),
+                         BattleWinner::None);
+            if (pool != nullptr) {
+                ThreadPool::TaskGroup battles(*pool);
+                for (BattleWinner &outcome: batch) {
+                    battles.submit([&playOne, &outcome] { playOne(outcome); });
+                }
+                battles.wait();
+            } else {
+                for (BattleWinner &outcome: batch) {
+                    playOne(outcome);
+                }
+            }
+            for (BattleWinner outcome: batch) {
+                estimate.battles++;
+                if (outcome == BattleWinner::TeamA) {
+                    estimate.wins++;
+                }
+            }
+            estimate.winRate = static_cast<double>(estimate.wins) / estimate.battles;
+            wilsonInterval(estimate, z);
+
+            double llr = estimate.wins * winStep + (estimate.battles - estimate.wins) * lossStep;
+            if (llr >= upperBound) {
+                estimate.decision = SprtDecision::AcceptHigh;
+            } else if (llr <= lowerBound) {
+                estimate.decision = SprtDecision::AcceptLow;
+            } else {
+                estimate.decision = SprtDecision::Undecided;
+            }
+
+            if (estimate.battles < options.minBattles) {
+                continue;
+            }
+            if (options.rule == StoppingRule::ConfidenceWidth &&
+                estimate.upper - estimate.lower <= 2 * options.halfWidth) {
+                break;
+            }
+            if (options.rule == StoppingRule::Sprt && estimate.decision != SprtDecision::Undecided) {
+                break;
+            }
+        }
+        estimate.saved = options.maxBattles - estimate.battles;
+        return estimate;
+    }
+
+}
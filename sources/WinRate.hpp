@@ -0,0 +1,62 @@
+/**
+ * @file WinRate.hpp
+ * @brief Monte Carlo estimation of the win rate of one team against another, with sequential early stopping.
+ * @author Tomer Gozlan
+ * @date 19/10/2026
+ */
+
+#ifndef COWBOY_VS_NINJA_A_WINRATE_HPP
+#define COWBOY_VS_NINJA_A_WINRATE_HPP
+
+#include "Battle.hpp"
+#include "Tournament.hpp"
+
+namespace ariel {
+
+    enum class StoppingRule {
+        // Always play maxBattles battles.
+        Fixed,
+        // Stop when the Wilson confidence interval is narrower than 2 * halfWidth.
+        ConfidenceWidth,
+        // Wald's sequential probability ratio test of winRate <= p0 against winRate >= p1.
+        Sprt
+    };
+
+    enum class SprtDecision {
+        Undecided,
+        AcceptLow,
+        AcceptHigh
+    };
+
+    struct WinRateOptions {
+        StoppingRule rule = StoppingRule::ConfidenceWidth;
+        int maxBattles = 100000;
+        // Stopping is checked only after this many battles, and then after every batch.
+        int minBattles = 30;
+        int batchSize = 16;
+        double confidence = 0.95;
+        double halfWidth = 0.01;
+        double p0 = 0.45;
+        double p1 = 0.55;
+        double alpha = 0.05;
+        double beta = 0.05;
+        BattleOptions battle;
+    };
+
+    struct WinRateEstimate {
+        int battles = 0;
+        int wins = 0;
+        // Battles not played compared to a fixed run of maxBattles.
+        int saved = 0;
+        double winRate = 0;
+        double lower = 0;
+        double upper = 1;
+        SprtDecision decision = SprtDecision::Undecided;
+    };
+
+    WinRateEstimate estimateWinRate(const TeamFactory &teamA, const TeamFactory &teamB, const WinRateOptions &options,
+                                    ThreadPool *pool = nullptr);
+
+}
+
+#endif //COWBOY_VS_NINJA_A_WINRATE_HPP